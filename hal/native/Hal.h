@@ -0,0 +1,107 @@
+#pragma once
+
+// Haki hosta dla symulacji sprzętu ([env:native])
+
+#include <functional>
+#include <mutex>
+
+#include <Arduino.h>
+#include "driver/uart.h"
+
+// ESP.restart() na hoście - łapany w pętli głównej; zadania FreeRTOS
+// sprzed restartu kończą się przy najbliższym czekaniu
+struct HalRestart {};
+
+// Monotoniczny czas od startu [us]; w trybie symulacji czas wirtualny
+int64_t halMicros();
+
+// Blokujące czekanie (delay, vTaskDelay, light sleep)
+void halSleepUs(int64_t us);
+
+// Wspólna blokada stanu HAL (kolejki, UART, harmonogram)
+std::unique_lock<std::mutex> halLock();
+
+// Czeka z zajętą halLock() na spełnienie warunku, najwyżej timeoutUs
+// zegara firmware (< 0 - bez limitu). W symulacji czas rusza dopiero, gdy wszystkie
+// wątki firmware czekają.
+bool halWait(std::unique_lock<std::mutex> &lock, const std::function<bool()> &ready, int64_t timeoutUs);
+
+// Budzi czekających po zmianie stanu (z zajętą halLock())
+void halNotify();
+
+// Rejestracja wątku firmware (zadania FreeRTOS, pętla główna)
+void halThreadStart();
+void halThreadStop();
+
+// Wątek jest zadaniem FreeRTOS bieżącego uruchomienia firmware
+void halTaskBegin();
+
+// Reset: zadania i sterowniki UART sprzed restartu przestają działać
+void halRestart();
+
+// Wywoływane, gdy wątek, który zmienił LCD, zaczyna czekać - ekran
+// jest wtedy kompletny (poza blokadą HAL)
+void halSetLcdHook(void (*hook)());
+
+// Bajty odebrane przez UART (jak z linii RX odbiornika GPS)
+void halUartInject(uart_port_t port, const uint8_t *data, size_t len);
+
+// Bieżąca prędkość UART ustawiona przez firmware
+uint32_t halUartBaud(uart_port_t port);
+
+// Liczba bajtów odebranych przez UART od startu
+uint64_t halUartRxBytes(uart_port_t port);
+
+// Light sleep przerwane przez UART i znaki utracone przy tych pobudkach
+uint32_t halUartWakeups(uint64_t *lostBytes);
+
+// Model odbiornika GNSS na UART (w symulacji): fiksy od chwili utc
+// w 1 s czasu wirtualnego, konfiguracja poleceniami PCAS
+void halGnssBegin(uart_port_t port, time_t utc);
+
+// Ostatnia wartość zapisana na pin (digitalWrite/analogWrite)
+int halPinValue(uint8_t pin);
+
+// Liczba wywołań settimeofday() i chwila pierwszego z nich (halSimMicros
+// w symulacji, inaczej halMicros)
+int halClockSets(int64_t *firstUs);
+
+// Widoczna część wiersza modelu LCD (CGRAM jako '\x00'..'\x07');
+// nullptr przed inicjalizacją wyświetlacza
+const char *halLcdRow(uint8_t row);
+
+// Liczniki modelu LCD od startu
+struct HalLcdCounters {
+  uint64_t i2cBytes;       // bajty do ekspandera PCF8574
+  uint64_t transactions;   // transmisje I2C (endTransmission)
+  uint64_t cellWrites;     // znaki zapisane w widocznej części DDRAM
+  uint64_t cellChanges;    // j.w., które zmieniły znak na ekranie
+};
+HalLcdCounters halLcdCounters();
+
+// Kończy ramkę (ekran kompletny): liczba znaków zapisanych bez zmiany,
+// poza pojedynczymi znakami między dwiema zmianami; -1, gdy w ramce (albo
+// w poprzedniej, bez zapisu znaków) było czyszczenie ekranu lub zapis CGRAM
+int halLcdEndFrame();
+
+// Tryb symulacji: czas wirtualny, wejście z harmonogramu; zegar firmware
+// chodzi o ppm milionowych części szybciej od czasu prawdziwego
+void halSimBegin(double ppm = 0);
+bool halSimActive();
+
+// Czas prawdziwy symulacji [us] (halMicros() to zegar firmware)
+int64_t halSimMicros();
+
+// Czekanie wątku HAL (np. modelu odbiornika) do chwili czasu prawdziwego
+void halSimSleepUntil(int64_t trueUs);
+
+// Dane dla UART nadane z prędkością baud, dostarczane w chwili atUs
+// czasu wirtualnego (przy innej prędkości UART - śmieci)
+void halSimSchedule(int64_t atUs, uart_port_t port, uint32_t baud, const uint8_t *data, size_t len);
+
+// Wszystkie zaplanowane dane zostały dostarczone
+bool halSimInputDone();
+
+// Serial (USB CDC) na pseudoterminalu w obie strony zamiast stdout;
+// ścieżka dla klienta hosta lub nullptr
+const char *halUsbPtyOpen();
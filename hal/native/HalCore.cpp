@@ -0,0 +1,319 @@
+#include "Hal.h"
+#include "HalInternal.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <termios.h>
+#include <unistd.h>
+#include <deque>
+#include <map>
+#include <mutex>
+#include <thread>
+
+#include <Preferences.h>
+#include <WiFi.h>
+
+#include "esp_pm.h"
+#include "esp_sleep.h"
+#include "esp_system.h"
+#include "esp_timer.h"
+
+HostSerial Serial;
+EspClass ESP;
+WiFiClass WiFi;
+
+static std::mutex pinLock;
+static std::map<uint8_t, int> pinValues;
+static uint32_t cpuMhz = 240;
+static uint64_t sleepTimerUs = 0;
+
+// Zegar systemowy (settimeofday) liczony od startu jak na ESP32: od 1970-01-01
+static std::mutex clockLock;
+static int64_t wallOffsetUs = 0;
+static int clockSets = 0;
+static int64_t firstSetUs = -1;
+
+// adjtime() jak w ESP-IDF: korekta rozłożona w czasie z szybkością 1/64
+static const int ADJTIME_CORRECTION_SHIFT = 6;
+static int64_t slewStartUs = 0;
+static int64_t slewTotalUs = 0;
+
+int halPinValue(uint8_t pin) {
+  std::lock_guard<std::mutex> guard(pinLock);
+  auto it = pinValues.find(pin);
+  return it == pinValues.end() ? -1 : it->second;
+}
+
+int64_t esp_timer_get_time() {
+  return halMicros();
+}
+
+uint32_t millis() {
+  return (uint32_t)(halMicros() / 1000);
+}
+
+uint32_t micros() {
+  return (uint32_t)halMicros();
+}
+
+void delay(uint32_t ms) {
+  halSleepUs((int64_t)ms * 1000);
+}
+
+void delayMicroseconds(uint32_t us) {
+  halSleepUs(us);
+}
+
+void pinMode(uint8_t pin, uint8_t mode) {
+  (void)pin;
+  (void)mode;
+}
+
+void digitalWrite(uint8_t pin, uint8_t value) {
+  std::lock_guard<std::mutex> guard(pinLock);
+  pinValues[pin] = value;
+}
+
+int digitalRead(uint8_t pin) {
+  int value = halPinValue(pin);
+  return value < 0 ? LOW : value;
+}
+
+void analogWrite(uint8_t pin, int value) {
+  std::lock_guard<std::mutex> guard(pinLock);
+  pinValues[pin] = value;
+}
+
+int digitalPinToInterrupt(uint8_t pin) {
+  return pin;
+}
+
+void attachInterrupt(int interrupt, void (*isr)(), int mode) {
+  (void)interrupt;
+  (void)isr;
+  (void)mode;
+}
+
+bool setCpuFrequencyMhz(uint32_t mhz) {
+  cpuMhz = mhz;
+  return true;
+}
+
+uint32_t getCpuFrequencyMhz() {
+  return cpuMhz;
+}
+
+// Serial na pseudoterminalu (halUsbPtyOpen)
+static std::mutex usbLock;
+static int usbPty = -1;
+static std::deque<uint8_t> usbRx;
+static esp_event_handler_t usbRxHandler = nullptr;
+
+// Wątek odbioru: bajty z pseudoterminala i zdarzenie jak z zadania USB
+static void usbPtyReader() {
+  uint8_t buffer[64];
+  while (true) {
+    struct pollfd ready = {usbPty, POLLIN, 0};
+    ssize_t n = poll(&ready, 1, -1) > 0 ? read(usbPty, buffer, sizeof(buffer)) : -1;
+    if (n <= 0) {
+      usleep(100000);  // EIO, gdy klient zamknął swoją stronę
+      continue;
+    }
+    esp_event_handler_t handler;
+    {
+      std::lock_guard<std::mutex> guard(usbLock);
+      usbRx.insert(usbRx.end(), buffer, buffer + n);
+      handler = usbRxHandler;
+    }
+    if (handler != nullptr) {
+      handler(nullptr, "ARDUINO_USB_CDC_EVENTS", ARDUINO_USB_CDC_RX_EVENT, nullptr);
+    }
+  }
+}
+
+const char *halUsbPtyOpen() {
+  int pty = posix_openpt(O_RDWR | O_NOCTTY);
+  if (pty < 0 || grantpt(pty) < 0 || unlockpt(pty) < 0) {
+    return nullptr;
+  }
+  struct termios raw;
+  tcgetattr(pty, &raw);
+  cfmakeraw(&raw);
+  tcsetattr(pty, TCSANOW, &raw);
+  // Bez klienta zapis nie może blokować firmware - nadmiar przepada jak na USB
+  fcntl(pty, F_SETFL, fcntl(pty, F_GETFL) | O_NONBLOCK);
+  usbPty = pty;
+  std::thread(usbPtyReader).detach();
+  return ptsname(pty);
+}
+
+void HostSerial::onEvent(arduino_usb_cdc_event_t event, esp_event_handler_t callback) {
+  if (event == ARDUINO_USB_CDC_RX_EVENT) {
+    std::lock_guard<std::mutex> guard(usbLock);
+    usbRxHandler = callback;
+  }
+}
+
+int HostSerial::available() {
+  std::lock_guard<std::mutex> guard(usbLock);
+  return (int)usbRx.size();
+}
+
+int HostSerial::read() {
+  std::lock_guard<std::mutex> guard(usbLock);
+  if (usbRx.empty()) {
+    return -1;
+  }
+  int c = usbRx.front();
+  usbRx.pop_front();
+  return c;
+}
+
+int HostSerial::peek() {
+  std::lock_guard<std::mutex> guard(usbLock);
+  return usbRx.empty() ? -1 : usbRx.front();
+}
+
+size_t HostSerial::write(uint8_t c) {
+  return write(&c, 1);
+}
+
+size_t HostSerial::write(const uint8_t *buffer, size_t size) {
+  if (usbPty >= 0) {
+    // Jedno wywołanie write() - ramki z różnych zadań się nie przeplatają
+    ssize_t n = ::write(usbPty, buffer, size);
+    return n < 0 ? 0 : (size_t)n;
+  }
+  return fwrite(buffer, 1, size, stdout);
+}
+
+static esp_reset_reason_t resetReason = ESP_RST_POWERON;
+
+void EspClass::restart() {
+  resetReason = ESP_RST_SW;
+  halRestart();
+  throw HalRestart();
+}
+
+esp_reset_reason_t esp_reset_reason() {
+  return resetReason;
+}
+
+// Przestrzenie NVS: nazwa/klucz -> wartość
+static std::mutex nvsLock;
+static std::map<std::string, float> nvs;
+
+bool Preferences::begin(const char *name, bool readOnly) {
+  (void)readOnly;
+  space = std::string(name) + "/";
+  return true;
+}
+
+size_t Preferences::putFloat(const char *key, float value) {
+  std::lock_guard<std::mutex> guard(nvsLock);
+  nvs[space + key] = value;
+  return sizeof(value);
+}
+
+float Preferences::getFloat(const char *key, float defaultValue) {
+  std::lock_guard<std::mutex> guard(nvsLock);
+  auto it = nvs.find(space + key);
+  return it == nvs.end() ? defaultValue : it->second;
+}
+
+bool Preferences::isKey(const char *key) {
+  std::lock_guard<std::mutex> guard(nvsLock);
+  return nvs.count(space + key) != 0;
+}
+
+esp_err_t esp_pm_configure(const void *config) {
+  (void)config;
+  return ESP_OK;
+}
+
+esp_err_t esp_sleep_enable_timer_wakeup(uint64_t timeUs) {
+  sleepTimerUs = timeUs;
+  return ESP_OK;
+}
+
+esp_err_t esp_sleep_enable_uart_wakeup(int port) {
+  halUartWakeupEnable(port);
+  return ESP_OK;
+}
+
+esp_err_t esp_light_sleep_start() {
+  halUartLightSleep((int64_t)sleepTimerUs);
+  return ESP_OK;
+}
+
+int halClockSets(int64_t *firstUs) {
+  std::lock_guard<std::mutex> guard(clockLock);
+  if (firstUs != nullptr) {
+    *firstUs = firstSetUs;
+  }
+  return clockSets;
+}
+
+// Część korekty adjtime() wprowadzona do chwili now (z zajętym clockLock)
+static int64_t slewApplied(int64_t now) {
+  int64_t done = (now - slewStartUs) >> ADJTIME_CORRECTION_SHIFT;
+  if (done >= llabs(slewTotalUs)) {
+    return slewTotalUs;
+  }
+  return slewTotalUs < 0 ? -done : done;
+}
+
+// Zegar systemowy firmware zamiast zegara hosta (symbole z libc są przesłaniane)
+static int64_t wallMicros() {
+  std::lock_guard<std::mutex> guard(clockLock);
+  int64_t now = halMicros();
+  return now + wallOffsetUs + slewApplied(now);
+}
+
+extern "C" {
+
+int gettimeofday(struct timeval *tv, void *tz) __THROW {
+  (void)tz;
+  int64_t now = wallMicros();
+  tv->tv_sec = (time_t)(now / 1000000);
+  tv->tv_usec = (suseconds_t)(now % 1000000);
+  return 0;
+}
+
+int settimeofday(const struct timeval *tv, const struct timezone *tz) __THROW {
+  (void)tz;
+  std::lock_guard<std::mutex> guard(clockLock);
+  int64_t now = halMicros();
+  wallOffsetUs = (int64_t)tv->tv_sec * 1000000 + tv->tv_usec - now;
+  slewTotalUs = 0;
+  if (clockSets++ == 0) {
+    firstSetUs = halSimActive() ? halSimMicros() : now;
+  }
+  return 0;
+}
+
+int adjtime(const struct timeval *delta, struct timeval *olddelta) __THROW {
+  std::lock_guard<std::mutex> guard(clockLock);
+  int64_t now = halMicros();
+  int64_t applied = slewApplied(now);
+  int64_t remaining = slewTotalUs - applied;
+  wallOffsetUs += applied;
+  slewStartUs = now;
+  slewTotalUs = delta != NULL ? (int64_t)delta->tv_sec * 1000000 + delta->tv_usec : remaining;
+  if (olddelta != NULL) {
+    olddelta->tv_sec = (time_t)(remaining / 1000000);
+    olddelta->tv_usec = (suseconds_t)(remaining % 1000000);
+  }
+  return 0;
+}
+
+time_t time(time_t *t) __THROW {
+  time_t now = (time_t)(wallMicros() / 1000000);
+  if (t != NULL) {
+    *t = now;
+  }
+  return now;
+}
+
+}  // extern "C"
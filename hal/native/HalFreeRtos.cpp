@@ -0,0 +1,211 @@
+#include <deque>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "HalInternal.h"
+#include "freertos/queue.h"
+#include "freertos/task.h"
+
+struct HalQueue {
+  std::deque<std::vector<uint8_t>> items;
+  UBaseType_t length;
+  UBaseType_t itemSize;
+};
+
+struct HalTask {
+  std::thread thread;
+  std::string name;
+  uint32_t stackDepth;
+  uint32_t notifyValue = 0;
+  bool notifyPending = false;
+};
+
+// Zadanie wykonywane przez bieżący wątek (nullptr - pętla główna)
+static thread_local HalTask *currentTask = nullptr;
+
+// Stos pętli Arduino (loopTask) w ESP32-S2
+static const UBaseType_t LOOP_TASK_STACK = 8192;
+
+// Limit oczekiwania w us (1 tick = 1 ms)
+static int64_t ticksToUs(TickType_t wait) {
+  return wait == portMAX_DELAY ? -1 : (int64_t)wait * 1000;
+}
+
+static void push(QueueHandle_t queue, const void *item) {
+  const uint8_t *bytes = static_cast<const uint8_t *>(item);
+  queue->items.emplace_back(bytes, bytes + queue->itemSize);
+  halNotify();
+}
+
+QueueHandle_t xQueueCreate(UBaseType_t length, UBaseType_t itemSize) {
+  HalQueue *queue = new HalQueue();
+  queue->length = length;
+  queue->itemSize = itemSize;
+  return queue;
+}
+
+bool halQueueSendLocked(QueueHandle_t queue, const void *item) {
+  if (queue->items.size() >= queue->length) {
+    return false;
+  }
+  push(queue, item);
+  return true;
+}
+
+BaseType_t xQueueSend(QueueHandle_t queue, const void *item, TickType_t wait) {
+  std::unique_lock<std::mutex> lock = halLock();
+  if (!halWait(lock, [queue] { return queue->items.size() < queue->length; }, ticksToUs(wait))) {
+    return pdFALSE;
+  }
+  push(queue, item);
+  return pdTRUE;
+}
+
+BaseType_t xQueueSendFromISR(QueueHandle_t queue, const void *item, BaseType_t *woken) {
+  if (woken != NULL) {
+    *woken = pdFALSE;
+  }
+  return xQueueSend(queue, item, 0);
+}
+
+BaseType_t xQueueReceive(QueueHandle_t queue, void *item, TickType_t wait) {
+  std::unique_lock<std::mutex> lock = halLock();
+  if (!halWait(lock, [queue] { return !queue->items.empty(); }, ticksToUs(wait))) {
+    return pdFALSE;
+  }
+  memcpy(item, queue->items.front().data(), queue->itemSize);
+  queue->items.pop_front();
+  halNotify();
+  return pdTRUE;
+}
+
+BaseType_t xQueueReset(QueueHandle_t queue) {
+  std::unique_lock<std::mutex> lock = halLock();
+  queue->items.clear();
+  halNotify();
+  return pdPASS;
+}
+
+UBaseType_t uxQueueMessagesWaiting(QueueHandle_t queue) {
+  std::unique_lock<std::mutex> lock = halLock();
+  return (UBaseType_t)queue->items.size();
+}
+
+BaseType_t xTaskCreate(TaskFunction_t code, const char *name, uint32_t stackDepth,
+                       void *param, UBaseType_t priority, TaskHandle_t *handle) {
+  (void)name;
+  (void)priority;
+  HalTask *task = new HalTask();
+  task->name = name;
+  task->stackDepth = stackDepth;
+  halThreadStart();  // przed startem wątku, żeby czas wirtualny na niego poczekał
+  task->thread = std::thread([task, code, param] {
+    currentTask = task;
+    halTaskBegin();
+    try {
+      code(param);
+    } catch (const HalRestart &) {
+      // ESP.restart() - zadanie przestaje istnieć
+    }
+    halThreadStop();
+  });
+  task->thread.detach();
+  if (handle != NULL) {
+    *handle = task;
+  }
+  return pdPASS;
+}
+
+BaseType_t xTaskCreatePinnedToCore(TaskFunction_t code, const char *name, uint32_t stackDepth,
+                                   void *param, UBaseType_t priority, TaskHandle_t *handle,
+                                   BaseType_t core) {
+  (void)core;
+  return xTaskCreate(code, name, stackDepth, param, priority, handle);
+}
+
+void vTaskDelay(TickType_t ticks) {
+  halSleepUs((int64_t)ticks * 1000);
+}
+
+void vTaskDelete(TaskHandle_t task) {
+  (void)task;
+}
+
+TickType_t xTaskGetTickCount() {
+  return (TickType_t)(halMicros() / 1000);
+}
+
+TaskHandle_t xTaskGetCurrentTaskHandle() {
+  return currentTask;
+}
+
+const char *pcTaskGetName(TaskHandle_t task) {
+  if (task == NULL) {
+    task = currentTask;
+  }
+  return task != NULL ? task->name.c_str() : "loopTask";
+}
+
+BaseType_t xTaskNotify(TaskHandle_t task, uint32_t value, eNotifyAction action) {
+  std::unique_lock<std::mutex> lock = halLock();
+  switch (action) {
+    case eSetBits:
+      task->notifyValue |= value;
+      break;
+    case eIncrement:
+      task->notifyValue++;
+      break;
+    case eSetValueWithOverwrite:
+      task->notifyValue = value;
+      break;
+    default:
+      break;
+  }
+  task->notifyPending = true;
+  halNotify();
+  return pdPASS;
+}
+
+BaseType_t xTaskNotifyGive(TaskHandle_t task) {
+  return xTaskNotify(task, 0, eIncrement);
+}
+
+uint32_t ulTaskNotifyTake(BaseType_t clearOnExit, TickType_t wait) {
+  HalTask *task = currentTask;
+  std::unique_lock<std::mutex> lock = halLock();
+  halWait(lock, [task] { return task->notifyValue != 0; }, ticksToUs(wait));
+  uint32_t value = task->notifyValue;
+  if (value != 0) {
+    task->notifyValue = clearOnExit ? 0 : value - 1;
+  }
+  task->notifyPending = false;
+  return value;
+}
+
+BaseType_t xTaskNotifyWait(uint32_t clearOnEntry, uint32_t clearOnExit, uint32_t *value, TickType_t wait) {
+  HalTask *task = currentTask;
+  std::unique_lock<std::mutex> lock = halLock();
+  if (!task->notifyPending) {
+    task->notifyValue &= ~clearOnEntry;
+  }
+  bool received = halWait(lock, [task] { return task->notifyPending; }, ticksToUs(wait));
+  if (value != NULL) {
+    *value = task->notifyValue;
+  }
+  if (received) {
+    task->notifyValue &= ~clearOnExit;
+    task->notifyPending = false;
+  }
+  return received ? pdTRUE : pdFALSE;
+}
+
+// Wątki hosta mają duże stosy - raportujemy cały przydział jako wolny
+UBaseType_t uxTaskGetStackHighWaterMark(TaskHandle_t task) {
+  return task != NULL ? (UBaseType_t)task->stackDepth : LOOP_TASK_STACK;
+}
+
+// Wątki hosta nie mają zadania bezczynności
+TaskHandle_t xTaskGetIdleTaskHandle() {
+  return NULL;
+}
@@ -0,0 +1,179 @@
+// Model odbiornika AT6558R dla symulacji: paczka zdań co fiks, zaczynająca
+// się GPS_RECEIVER_LATENCY_US po sekundzie UTC, nadawana w tempie swojej
+// prędkości łącza. Rozumie PCAS01 (prędkość), PCAS02 (okres fiksa)
+// i PCAS03 (zestaw zdań); ustawienia fabryczne jak po włączeniu zasilania.
+
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "GpsTime.h"
+#include "HalInternal.h"
+#include "TimeLib.h"
+
+namespace {
+
+enum Sentence { GGA, GLL, GSA, GSV, RMC, VTG, ZDA, ANT, SENTENCE_COUNT };
+
+struct Receiver {
+  uart_port_t port = UART_NUM_MAX;
+  int64_t utcAtZeroUs = 0;
+  uint32_t baud = 9600;
+  uint32_t intervalMs = 1000;
+  bool enabled[SENTENCE_COUNT] = {true, true, true, true, true, true, true, true};
+  std::string command;        // odbierane polecenie
+};
+
+Receiver receiver;
+
+std::string checksummed(const std::string &body) {
+  uint8_t sum = 0;
+  for (char c : body) {
+    sum ^= (uint8_t)c;
+  }
+  char tail[8];
+  snprintf(tail, sizeof(tail), "*%02X\r\n", sum);
+  return "$" + body + tail;
+}
+
+// Zdania jednego fiksa dla chwili utcUs
+std::vector<std::string> burst(int64_t utcUs) {
+  int64_t seconds = utcUs / 1000000;
+  int64_t days = seconds / 86400;
+  int secs = (int)(seconds % 86400);
+  int centis = (int)(utcUs % 1000000 / 10000);
+  char hms[16];
+  char dmy[8];
+  char zda[32];
+  snprintf(hms, sizeof(hms), "%02d%02d%02d.%02d", secs / 3600, secs / 60 % 60, secs % 60, centis);
+  snprintf(dmy, sizeof(dmy), "%02u%02u%02d", civilDayFromDays(days), civilMonthFromDays(days),
+           (int)(civilYearFromDays(days) % 100));
+  snprintf(zda, sizeof(zda), "%02u,%02u,%04d", civilDayFromDays(days), civilMonthFromDays(days),
+           (int)civilYearFromDays(days));
+  const std::string t(hms);
+  const std::string pos = "5213.00000,N,02100.00000,E";
+
+  std::vector<std::string> out;
+  if (receiver.enabled[GGA]) out.push_back(checksummed("GNGGA," + t + "," + pos + ",1,08,1.0,100.0,M,34.5,M,,"));
+  if (receiver.enabled[GLL]) out.push_back(checksummed("GNGLL," + pos + "," + t + ",A,A"));
+  if (receiver.enabled[GSA]) {
+    out.push_back(checksummed("GNGSA,A,3,01,02,12,14,,,,,,,,,1.8,1.0,1.5,1"));
+    out.push_back(checksummed("GNGSA,A,3,06,09,16,21,,,,,,,,,1.8,1.0,1.5,4"));
+  }
+  if (receiver.enabled[GSV]) {
+    out.push_back(checksummed("GPGSV,3,1,10,01,40,083,46,02,17,308,41,12,07,344,39,14,22,228,45,0"));
+    out.push_back(checksummed("GPGSV,3,2,10,15,30,120,38,17,52,262,44,19,11,045,30,24,63,181,47,0"));
+    out.push_back(checksummed("GPGSV,3,3,10,25,05,020,,32,14,300,28,0"));
+    out.push_back(checksummed("BDGSV,2,1,06,06,47,223,40,09,38,189,37,16,55,205,42,21,22,078,33,0"));
+    out.push_back(checksummed("BDGSV,2,2,06,22,17,150,30,34,62,310,44,0"));
+  }
+  if (receiver.enabled[RMC]) out.push_back(checksummed("GNRMC," + t + ",A," + pos + ",0.00,0.00," + dmy + ",,,A,V"));
+  if (receiver.enabled[VTG]) out.push_back(checksummed("GNVTG,0.00,T,,M,0.00,N,0.00,K,A"));
+  if (receiver.enabled[ZDA]) out.push_back(checksummed("GNZDA," + t + "," + zda + ",00,00"));
+  if (receiver.enabled[ANT]) out.push_back(checksummed("GPTXT,01,01,01,ANTENNA OK"));
+  return out;
+}
+
+// Polecenie PCAS od firmware (z zajętą halLock())
+void execute(const std::string &line) {
+  size_t star = line.find('*');
+  if (line.compare(0, 5, "$PCAS") != 0 || star == std::string::npos) {
+    return;
+  }
+  uint8_t sum = 0;
+  for (size_t i = 1; i < star; i++) {
+    sum ^= (uint8_t)line[i];
+  }
+  if (strtoul(line.substr(star + 1, 2).c_str(), nullptr, 16) != sum) {
+    return;
+  }
+
+  std::vector<std::string> fields;
+  size_t start = 1;
+  while (start <= star) {
+    size_t end = line.find_first_of(",*", start);
+    fields.push_back(line.substr(start, end - start));
+    start = end + 1;
+  }
+
+  static const uint32_t bauds[] = {4800, 9600, 19200, 38400, 57600, 115200};
+  if (fields[0] == "PCAS01" && fields.size() > 1) {
+    unsigned code = (unsigned)atoi(fields[1].c_str());
+    if (code < sizeof(bauds) / sizeof(bauds[0])) {
+      receiver.baud = bauds[code];
+    }
+  } else if (fields[0] == "PCAS02" && fields.size() > 1) {
+    uint32_t ms = (uint32_t)atoi(fields[1].c_str());
+    if (ms == 1000 || ms == 500 || ms == 250 || ms == 200 || ms == 100) {
+      receiver.intervalMs = ms;
+    }
+  } else if (fields[0] == "PCAS03") {
+    static const int order[] = {GGA, GLL, GSA, GSV, RMC, VTG, ZDA, ANT};
+    for (size_t i = 0; i < SENTENCE_COUNT && i + 1 < fields.size(); i++) {
+      if (!fields[i + 1].empty()) {
+        receiver.enabled[order[i]] = atoi(fields[i + 1].c_str()) != 0;
+      }
+    }
+  }
+}
+
+// Nadaje jedno zdanie w tempie łącza odbiornika
+void transmit(const std::string &line) {
+  uint32_t baud;
+  {
+    std::unique_lock<std::mutex> lock = halLock();
+    baud = receiver.baud;
+  }
+  halSimSleepUntil(halSimMicros() + (int64_t)line.size() * 10000000LL / baud);
+
+  std::unique_lock<std::mutex> lock = halLock();
+  halUartTransmitLocked(receiver.port, (const uint8_t *)line.data(), line.size(), baud);
+}
+
+void run() {
+  int64_t fixUs = 1000000;
+  while (true) {
+    halSimSleepUntil(fixUs + GPS_RECEIVER_LATENCY_US);
+    std::vector<std::string> lines;
+    uint32_t intervalMs;
+    {
+      std::unique_lock<std::mutex> lock = halLock();
+      lines = burst(receiver.utcAtZeroUs + fixUs);
+      intervalMs = receiver.intervalMs;
+    }
+    for (const std::string &line : lines) {
+      transmit(line);
+    }
+    fixUs += (int64_t)intervalMs * 1000;
+  }
+}
+
+}  // namespace
+
+void halGnssBegin(uart_port_t port, time_t utc) {
+  {
+    std::unique_lock<std::mutex> lock = halLock();
+    receiver.port = port;
+    receiver.utcAtZeroUs = (int64_t)utc * 1000000 - 1000000;  // pierwszy fiks w 1 s
+  }
+  halThreadStart();
+  std::thread(run).detach();
+}
+
+void halGnssReceiveLocked(uart_port_t port, const uint8_t *data, size_t len) {
+  if (port != receiver.port || halUartBaudLocked(port) != receiver.baud) {
+    return;  // przy złej prędkości odbiornik nie rozpozna polecenia
+  }
+  for (size_t i = 0; i < len; i++) {
+    char c = (char)data[i];
+    if (c == '$') {
+      receiver.command.clear();
+    }
+    if (c == '\n') {
+      execute(receiver.command);
+      receiver.command.clear();
+    } else if (c != '\r' && receiver.command.size() < 96) {
+      receiver.command += c;
+    }
+  }
+}
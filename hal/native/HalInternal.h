@@ -0,0 +1,34 @@
+#pragma once
+
+// Wspólne elementy implementacji HAL (nie dla firmware)
+
+#include "Hal.h"
+#include "freertos/queue.h"
+
+// halUartInject() z zajętą halLock()
+void halUartInjectLocked(uart_port_t port, const uint8_t *data, size_t len);
+
+// xQueueSend() bez czekania z zajętą halLock()
+bool halQueueSendLocked(QueueHandle_t queue, const void *item);
+
+// Bajty nadane z prędkością baud; przy innej prędkości UART firmware
+// dostaje śmieci (z zajętą halLock())
+void halUartTransmitLocked(uart_port_t port, const uint8_t *data, size_t len, uint32_t baud);
+
+// Prędkość UART z zajętą halLock()
+uint32_t halUartBaudLocked(uart_port_t port);
+
+// Ten wątek zmienił LCD od ostatniego wywołania
+bool halLcdTakeChanged();
+
+// Usuwa sterowniki UART (reset, z zajętą halLock())
+void halUartResetLocked();
+
+// Bajty wysłane przez firmware do modelu odbiornika (z zajętą halLock())
+void halGnssReceiveLocked(uart_port_t port, const uint8_t *data, size_t len);
+
+// Light sleep przerywany przez UART z włączoną pobudką (esp_light_sleep_start)
+void halUartLightSleep(int64_t us);
+
+// esp_sleep_enable_uart_wakeup
+void halUartWakeupEnable(int port);
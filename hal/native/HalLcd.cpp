@@ -0,0 +1,215 @@
+#include "HalInternal.h"
+
+#include <Wire.h>
+
+// Model HD44780 2x16 za ekspanderem PCF8574 (P0 RS, P2 EN, P4-P7 D4-D7).
+// Półbajty zatrzaskiwane są opadającym zboczem EN, jak w sterowniku.
+
+TwoWire Wire;
+
+static const uint8_t LCD_COLS = 16;
+static const uint8_t LCD_ROWS = 2;
+static const uint8_t PCF_RS = 0x01;
+static const uint8_t PCF_EN = 0x04;
+
+struct LcdModel {
+  bool started = false;       // po pierwszym zatrzaśnięciu
+  bool fourBit = false;       // po włączeniu zasilania tryb 8-bitowy
+  bool highPending = false;   // w trybie 4-bitowym czeka młodszy półbajt
+  uint8_t high = 0;
+  uint8_t lastPins = 0;
+  bool cgramMode = false;
+  uint8_t address = 0;
+  char shown[LCD_ROWS][LCD_COLS + 1];
+  uint8_t cgram[64];
+};
+
+static LcdModel model;
+
+// Niezmienione znaki, które LcdBuffer może wysłać między dwiema zmianami
+// (jego MAX_RUN_GAP) zamiast przestawiać kursor
+static const uint8_t BRIDGE_GAP = 1;
+
+// Ramka: zapisy od poprzedniego halLcdEndFrame()
+static bool frameWritten[LCD_ROWS][LCD_COLS];
+static bool frameChanged[LCD_ROWS][LCD_COLS];
+static bool frameRedraw = false;   // czyszczenie lub CGRAM w ramce
+static HalLcdCounters counters;
+
+// Wątek zmienił zawartość LCD (dla haka halSetLcdHook)
+static thread_local bool lcdChanged = false;
+
+bool halLcdTakeChanged() {
+  bool changed = lcdChanged;
+  lcdChanged = false;
+  return changed;
+}
+
+const char *halLcdRow(uint8_t row) {
+  return model.started && row < LCD_ROWS ? model.shown[row] : nullptr;
+}
+
+static void lcdClear() {
+  for (uint8_t r = 0; r < LCD_ROWS; r++) {
+    memset(model.shown[r], ' ', LCD_COLS);
+    model.shown[r][LCD_COLS] = '\0';
+  }
+  model.address = 0;
+  model.cgramMode = false;
+  lcdChanged = true;
+  frameRedraw = true;
+}
+
+static void lcdCommand(uint8_t value) {
+  if (value & 0x80) {
+    model.address = value & 0x7F;
+    model.cgramMode = false;
+  } else if (value & 0x40) {
+    model.address = value & 0x3F;
+    model.cgramMode = true;
+  } else if (value & 0x20) {
+    model.fourBit = (value & 0x10) == 0;
+    model.highPending = false;
+  } else if (value == 0x01) {
+    lcdClear();
+  } else if ((value & 0xFE) == 0x02) {
+    model.address = 0;
+    model.cgramMode = false;
+  }
+}
+
+static void lcdData(uint8_t value) {
+  if (model.cgramMode) {
+    model.cgram[model.address & 0x3F] = value;
+    model.address = (model.address + 1) & 0x3F;
+    lcdChanged = true;
+    frameRedraw = true;
+    return;
+  }
+  // Wiersz 0: adresy 0x00-0x27, wiersz 1: 0x40-0x67
+  uint8_t row = model.address >= 0x40 ? 1 : 0;
+  uint8_t col = model.address - (row ? 0x40 : 0);
+  if (col < LCD_COLS) {  // poza ekranem pamięć DDRAM nie jest pokazywana
+    counters.cellWrites++;
+    frameWritten[row][col] = true;
+    if (model.shown[row][col] != (char)value) {
+      counters.cellChanges++;
+      frameChanged[row][col] = true;
+    }
+    model.shown[row][col] = (char)value;
+  }
+  if (model.address == 0x27) {
+    model.address = 0x40;
+  } else if (model.address == 0x67) {
+    model.address = 0x00;
+  } else {
+    model.address++;
+  }
+  lcdChanged = true;
+}
+
+static void lcdLatch(uint8_t nibble, bool rs) {
+  if (!model.started) {
+    lcdClear();
+    model.started = true;
+  }
+  uint8_t value;
+  if (!model.fourBit) {
+    value = (uint8_t)(nibble << 4);  // D0-D3 niepodłączone
+  } else if (!model.highPending) {
+    model.high = nibble;
+    model.highPending = true;
+    return;
+  } else {
+    value = (uint8_t)(model.high << 4 | nibble);
+    model.highPending = false;
+  }
+  if (rs) {
+    lcdData(value);
+  } else {
+    lcdCommand(value);
+  }
+}
+
+static void pcfWrite(uint8_t pins) {
+  if ((model.lastPins & PCF_EN) && !(pins & PCF_EN)) {
+    lcdLatch(model.lastPins >> 4, model.lastPins & PCF_RS);
+  }
+  model.lastPins = pins;
+}
+
+HalLcdCounters halLcdCounters() {
+  return counters;
+}
+
+int halLcdEndFrame() {
+  int excess = 0;
+  bool written = false;
+  for (uint8_t r = 0; r < LCD_ROWS; r++) {
+    uint8_t c = 0;
+    while (c < LCD_COLS) {
+      written |= frameWritten[r][c];
+      if (!frameWritten[r][c] || frameChanged[r][c]) {
+        c++;
+        continue;
+      }
+      // Ciąg zapisanych bez zmiany: dopuszczalny tylko krótki, między zmianami
+      uint8_t end = c;
+      while (end < LCD_COLS && frameWritten[r][end] && !frameChanged[r][end]) {
+        end++;
+      }
+      bool bridge = c > 0 && frameChanged[r][c - 1] && end < LCD_COLS && frameChanged[r][end] &&
+                    end - c <= BRIDGE_GAP;
+      if (!bridge) {
+        excess += end - c;
+      }
+      c = end;
+    }
+  }
+  bool redraw = frameRedraw;
+  memset(frameWritten, 0, sizeof(frameWritten));
+  memset(frameChanged, 0, sizeof(frameChanged));
+  frameRedraw = redraw && !written;   // pełne odświeżenie po czyszczeniu bywa w następnej ramce
+  return redraw ? -1 : excess;
+}
+
+bool TwoWire::begin(int sda, int scl, uint32_t freq) {
+  (void)sda;
+  (void)scl;
+  if (freq != 0) {
+    frequency = freq;
+  }
+  return true;
+}
+
+bool TwoWire::setClock(uint32_t freq) {
+  frequency = freq;
+  return true;
+}
+
+void TwoWire::beginTransmission(uint8_t address) {
+  (void)address;
+}
+
+size_t TwoWire::write(uint8_t data) {
+  pcfWrite(data);
+  txBytes++;
+  counters.i2cBytes++;
+  return 1;
+}
+
+size_t TwoWire::write(const uint8_t *data, size_t size) {
+  for (size_t i = 0; i < size; i++) {
+    pcfWrite(data[i]);
+  }
+  txBytes += size;
+  counters.i2cBytes += size;
+  return size;
+}
+
+uint8_t TwoWire::endTransmission(bool sendStop) {
+  (void)sendStop;
+  txCount++;
+  counters.transactions++;
+  return 0;
+}
@@ -0,0 +1,243 @@
+// Synchronizacja wątków HAL i czas wirtualny symulacji.
+//
+// W trybie symulacji czas stoi, dopóki którykolwiek wątek firmware pracuje.
+// Gdy wszystkie czekają w halWait(), czas przeskakuje do najbliższego
+// terminu oczekiwania lub zaplanowanych danych wejściowych.
+// Czas wirtualny jest czasem prawdziwym; zegar firmware (halMicros) może
+// od niego odbiegać o zadany błąd kwarcu.
+
+#include <math.h>
+
+#include <chrono>
+#include <condition_variable>
+#include <list>
+#include <map>
+#include <vector>
+
+#include "HalInternal.h"
+
+namespace {
+
+struct Waiter {
+  const std::function<bool()> *ready;
+  int64_t deadline;
+};
+
+struct Input {
+  uart_port_t port;
+  uint32_t baud;
+  std::vector<uint8_t> data;
+};
+
+const int64_t FOREVER = INT64_MAX;
+
+std::mutex stateMutex;
+std::condition_variable changed;
+std::list<Waiter *> waiters;
+int threads = 0;
+int generation = 0;                   // zwiększane przez halRestart()
+thread_local bool taskThread = false;
+thread_local int taskGeneration = 0;
+void (*lcdHook)() = nullptr;
+
+bool simActive = false;
+int64_t simNowUs = 0;      // czas prawdziwy
+double simPpm = 0;         // błąd kwarcu firmware
+std::multimap<int64_t, Input> schedule;
+
+const std::chrono::steady_clock::time_point startTime = std::chrono::steady_clock::now();
+
+// Zadanie sprzed restartu (z zajętą blokadą)
+bool stale() {
+  return taskThread && taskGeneration != generation;
+}
+
+bool someoneReady() {
+  for (Waiter *w : waiters) {
+    if (simNowUs >= w->deadline || (*w->ready)()) {
+      return true;
+    }
+  }
+  return false;
+}
+
+// Przesuwa czas wirtualny do następnego zdarzenia (z zajętą blokadą)
+void advance() {
+  int64_t next = FOREVER;
+  for (Waiter *w : waiters) {
+    if (w->deadline < next) {
+      next = w->deadline;
+    }
+  }
+  if (!schedule.empty() && schedule.begin()->first < next) {
+    next = schedule.begin()->first;
+  }
+  if (next == FOREVER) {
+    return;  // nic już się nie wydarzy
+  }
+  if (next > simNowUs) {
+    simNowUs = next;
+  }
+  while (!schedule.empty() && schedule.begin()->first <= simNowUs) {
+    Input &input = schedule.begin()->second;
+    halUartTransmitLocked(input.port, input.data.data(), input.data.size(), input.baud);
+    schedule.erase(schedule.begin());
+  }
+  changed.notify_all();
+}
+
+}  // namespace
+
+int64_t halMicros() {
+  if (simActive) {
+    std::lock_guard<std::mutex> guard(stateMutex);
+    return simNowUs + (int64_t)((double)simNowUs * simPpm / 1e6);
+  }
+  return std::chrono::duration_cast<std::chrono::microseconds>(
+           std::chrono::steady_clock::now() - startTime).count();
+}
+
+std::unique_lock<std::mutex> halLock() {
+  return std::unique_lock<std::mutex>(stateMutex);
+}
+
+void halNotify() {
+  changed.notify_all();
+}
+
+void halThreadStart() {
+  std::lock_guard<std::mutex> guard(stateMutex);
+  threads++;
+}
+
+void halThreadStop() {
+  std::lock_guard<std::mutex> guard(stateMutex);
+  threads--;
+  changed.notify_all();
+}
+
+void halTaskBegin() {
+  std::lock_guard<std::mutex> guard(stateMutex);
+  taskThread = true;
+  taskGeneration = generation;
+}
+
+void halRestart() {
+  std::lock_guard<std::mutex> guard(stateMutex);
+  generation++;
+  halUartResetLocked();
+  changed.notify_all();
+}
+
+void halSetLcdHook(void (*hook)()) {
+  lcdHook = hook;
+}
+
+// Czekanie w symulacji do chwili deadline czasu prawdziwego
+static bool simWaitUntil(std::unique_lock<std::mutex> &lock, const std::function<bool()> &ready,
+                         int64_t deadline) {
+  Waiter self = {&ready, deadline};
+  waiters.push_back(&self);
+  bool result;
+  while (true) {
+    if (stale()) {
+      waiters.remove(&self);
+      throw HalRestart();
+    }
+    if (ready()) {
+      result = true;
+      break;
+    }
+    if (simNowUs >= self.deadline) {
+      result = false;
+      break;
+    }
+    if ((int)waiters.size() >= threads && !someoneReady()) {
+      advance();
+    } else {
+      changed.wait(lock);
+    }
+  }
+  waiters.remove(&self);
+  return result;
+}
+
+bool halWait(std::unique_lock<std::mutex> &lock, const std::function<bool()> &ready, int64_t timeoutUs) {
+  if (stale()) {
+    throw HalRestart();
+  }
+  if (ready()) {
+    return true;
+  }
+  if (timeoutUs == 0) {
+    return false;
+  }
+  if (lcdHook != nullptr && halLcdTakeChanged()) {
+    // Czas nie ruszy: ten wątek nie jest jeszcze na liście czekających
+    lock.unlock();
+    lcdHook();
+    lock.lock();
+    if (ready()) {
+      return true;
+    }
+  }
+
+  if (!simActive) {
+    std::function<bool()> readyOrStale = [&] { return stale() || ready(); };
+    bool result = timeoutUs < 0 ? (changed.wait(lock, readyOrStale), true)
+                                : changed.wait_for(lock, std::chrono::microseconds(timeoutUs), readyOrStale);
+    if (stale()) {
+      throw HalRestart();
+    }
+    return result;
+  }
+
+  // Limit odmierzany zegarem firmware
+  int64_t trueTimeoutUs = (int64_t)ceil((double)timeoutUs * 1e6 / (1e6 + simPpm));
+  return simWaitUntil(lock, ready, timeoutUs < 0 ? FOREVER : simNowUs + trueTimeoutUs);
+}
+
+void halSleepUs(int64_t us) {
+  if (us <= 0) {
+    return;
+  }
+  std::unique_lock<std::mutex> lock = halLock();
+  static const std::function<bool()> never = [] { return false; };
+  halWait(lock, never, us);
+}
+
+void halSimBegin(double ppm) {
+  std::lock_guard<std::mutex> guard(stateMutex);
+  simActive = true;
+  simNowUs = 0;
+  simPpm = ppm;
+}
+
+int64_t halSimMicros() {
+  std::lock_guard<std::mutex> guard(stateMutex);
+  return simNowUs;
+}
+
+void halSimSleepUntil(int64_t trueUs) {
+  std::unique_lock<std::mutex> lock = halLock();
+  static const std::function<bool()> never = [] { return false; };
+  simWaitUntil(lock, never, trueUs);
+}
+
+bool halSimActive() {
+  return simActive;
+}
+
+void halSimSchedule(int64_t atUs, uart_port_t port, uint32_t baud, const uint8_t *data, size_t len) {
+  std::lock_guard<std::mutex> guard(stateMutex);
+  Input input;
+  input.port = port;
+  input.baud = baud;
+  input.data.assign(data, data + len);
+  schedule.insert(std::make_pair(atUs, input));
+}
+
+bool halSimInputDone() {
+  std::lock_guard<std::mutex> guard(stateMutex);
+  return schedule.empty();
+}
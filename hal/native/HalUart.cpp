@@ -0,0 +1,314 @@
+#include <deque>
+#include <vector>
+
+#include "HalInternal.h"
+
+struct HalUart {
+  bool installed = false;
+  size_t rxCapacity = 0;
+  uint32_t baud = 115200;
+  QueueHandle_t events = nullptr;
+  std::deque<uint8_t> rx;
+  std::deque<uint64_t> patterns;   // bezwzględne numery bajtów '\n'
+  uint64_t readCount = 0;          // bajty już odczytane lub odrzucone
+  uint64_t rxCount = 0;            // bajty odebrane
+  uint64_t lineCount = 0;          // bajty na linii RX (razem z utraconymi)
+  char pattern = 0;
+  size_t patternQueueLen = 0;
+  int wakeThreshold = 0;           // uart_set_wakeup_threshold
+  bool wakeEnabled = false;        // esp_sleep_enable_uart_wakeup
+};
+
+static HalUart uarts[UART_NUM_MAX];
+
+// Light sleep (z zajętą halLock())
+static bool sleeping = false;
+static uint32_t uartWakeups = 0;
+static uint64_t wakeLostBytes = 0;
+
+static HalUart *uartFor(uart_port_t port) {
+  return (port >= 0 && port < UART_NUM_MAX) ? &uarts[port] : nullptr;
+}
+
+static void sendEvent(HalUart *uart, uart_event_type_t type, size_t size) {
+  if (uart->events == nullptr) {
+    return;
+  }
+  uart_event_t event = {};
+  event.type = type;
+  event.size = size;
+  halQueueSendLocked(uart->events, &event);
+}
+
+void halUartInjectLocked(uart_port_t port, const uint8_t *data, size_t len) {
+  HalUart *uart = uartFor(port);
+  if (uart == nullptr || !uart->installed) {
+    return;
+  }
+  uart->lineCount += len;
+  size_t start = 0;
+  if (sleeping && uart->wakeEnabled) {
+    // Pobudka z UART: zbocza pierwszych znaków tylko budzą CPU, znaki przepadają
+    start = len < (size_t)uart->wakeThreshold ? len : (size_t)uart->wakeThreshold;
+    sleeping = false;
+    uartWakeups++;
+    wakeLostBytes += start;
+    halNotify();
+  }
+  for (size_t i = start; i < len; i++) {
+    if (uart->rx.size() >= uart->rxCapacity) {
+      sendEvent(uart, UART_BUFFER_FULL, 1);
+      continue;
+    }
+    uart->rx.push_back(data[i]);
+    uart->rxCount++;
+    if (uart->pattern != 0 && data[i] == (uint8_t)uart->pattern &&
+        uart->patterns.size() < uart->patternQueueLen) {
+      uart->patterns.push_back(uart->rxCount - 1);
+      sendEvent(uart, UART_PATTERN_DET, 1);
+    }
+  }
+}
+
+void halUartTransmitLocked(uart_port_t port, const uint8_t *data, size_t len, uint32_t baud) {
+  static uint32_t noise = 12345;
+  uint32_t uartBaud = halUartBaudLocked(port);
+  if (uartBaud == baud) {
+    halUartInjectLocked(port, data, len);
+    return;
+  }
+  // Zła prędkość: inna liczba bajtów o przypadkowej treści
+  std::vector<uint8_t> garbage((size_t)((uint64_t)len * uartBaud / baud));
+  for (uint8_t &b : garbage) {
+    noise = noise * 1103515245 + 12345;
+    b = (uint8_t)(noise >> 16);
+  }
+  halUartInjectLocked(port, garbage.data(), garbage.size());
+}
+
+void halUartInject(uart_port_t port, const uint8_t *data, size_t len) {
+  std::unique_lock<std::mutex> lock = halLock();
+  halUartInjectLocked(port, data, len);
+}
+
+uint32_t halUartBaudLocked(uart_port_t port) {
+  HalUart *uart = uartFor(port);
+  return uart == nullptr ? 0 : uart->baud;
+}
+
+uint32_t halUartBaud(uart_port_t port) {
+  std::unique_lock<std::mutex> lock = halLock();
+  return halUartBaudLocked(port);
+}
+
+uint64_t halUartRxBytes(uart_port_t port) {
+  HalUart *uart = uartFor(port);
+  if (uart == nullptr) {
+    return 0;
+  }
+  std::unique_lock<std::mutex> lock = halLock();
+  return uart->lineCount;
+}
+
+esp_err_t uart_driver_install(uart_port_t port, int rxBufferSize, int txBufferSize,
+                              int queueSize, QueueHandle_t *queue, int intrFlags) {
+  (void)txBufferSize;
+  (void)intrFlags;
+  HalUart *uart = uartFor(port);
+  if (uart == nullptr) {
+    return ESP_FAIL;
+  }
+  std::unique_lock<std::mutex> lock = halLock();
+  if (uart->installed) {
+    return ESP_FAIL;
+  }
+  uart->installed = true;
+  uart->rxCapacity = (size_t)rxBufferSize;
+  if (queue != nullptr && queueSize > 0) {
+    uart->events = xQueueCreate(queueSize, sizeof(uart_event_t));
+    *queue = uart->events;
+  }
+  return ESP_OK;
+}
+
+void halUartResetLocked() {
+  for (HalUart &uart : uarts) {
+    uart.installed = false;
+    uart.events = nullptr;
+    uart.rx.clear();
+    uart.patterns.clear();
+    uart.pattern = 0;
+  }
+}
+
+esp_err_t uart_driver_delete(uart_port_t port) {
+  HalUart *uart = uartFor(port);
+  if (uart == nullptr) {
+    return ESP_FAIL;
+  }
+  std::unique_lock<std::mutex> lock = halLock();
+  uart->installed = false;
+  uart->events = nullptr;
+  uart->rx.clear();
+  uart->patterns.clear();
+  return ESP_OK;
+}
+
+bool uart_is_driver_installed(uart_port_t port) {
+  HalUart *uart = uartFor(port);
+  return uart != nullptr && uart->installed;
+}
+
+esp_err_t uart_param_config(uart_port_t port, const uart_config_t *config) {
+  return uart_set_baudrate(port, (uint32_t)config->baud_rate);
+}
+
+esp_err_t uart_set_pin(uart_port_t port, int tx, int rx, int rts, int cts) {
+  (void)port;
+  (void)tx;
+  (void)rx;
+  (void)rts;
+  (void)cts;
+  return ESP_OK;
+}
+
+esp_err_t uart_set_baudrate(uart_port_t port, uint32_t baud) {
+  HalUart *uart = uartFor(port);
+  if (uart == nullptr) {
+    return ESP_FAIL;
+  }
+  std::unique_lock<std::mutex> lock = halLock();
+  uart->baud = baud;
+  return ESP_OK;
+}
+
+esp_err_t uart_get_baudrate(uart_port_t port, uint32_t *baud) {
+  *baud = halUartBaud(port);
+  return ESP_OK;
+}
+
+esp_err_t uart_enable_pattern_det_baud_intr(uart_port_t port, char patternChr, uint8_t chrNum,
+                                            int chrTout, int postIdle, int preIdle) {
+  (void)chrNum;
+  (void)chrTout;
+  (void)postIdle;
+  (void)preIdle;
+  HalUart *uart = uartFor(port);
+  if (uart == nullptr) {
+    return ESP_FAIL;
+  }
+  std::unique_lock<std::mutex> lock = halLock();
+  uart->pattern = patternChr;
+  return ESP_OK;
+}
+
+esp_err_t uart_pattern_queue_reset(uart_port_t port, int queueLength) {
+  HalUart *uart = uartFor(port);
+  if (uart == nullptr) {
+    return ESP_FAIL;
+  }
+  std::unique_lock<std::mutex> lock = halLock();
+  uart->patterns.clear();
+  uart->patternQueueLen = (size_t)queueLength;
+  return ESP_OK;
+}
+
+int uart_pattern_pop_pos(uart_port_t port) {
+  HalUart *uart = uartFor(port);
+  if (uart == nullptr) {
+    return -1;
+  }
+  std::unique_lock<std::mutex> lock = halLock();
+  while (!uart->patterns.empty() && uart->patterns.front() < uart->readCount) {
+    uart->patterns.pop_front();  // bajt już odczytany
+  }
+  if (uart->patterns.empty()) {
+    return -1;
+  }
+  int pos = (int)(uart->patterns.front() - uart->readCount);
+  uart->patterns.pop_front();
+  return pos;
+}
+
+int uart_read_bytes(uart_port_t port, void *buf, uint32_t length, TickType_t wait) {
+  (void)wait;
+  HalUart *uart = uartFor(port);
+  if (uart == nullptr) {
+    return -1;
+  }
+  std::unique_lock<std::mutex> lock = halLock();
+  uint8_t *out = static_cast<uint8_t *>(buf);
+  uint32_t n = 0;
+  while (n < length && !uart->rx.empty()) {
+    out[n++] = uart->rx.front();
+    uart->rx.pop_front();
+  }
+  uart->readCount += n;
+  return (int)n;
+}
+
+int uart_write_bytes(uart_port_t port, const void *src, size_t size) {
+  std::unique_lock<std::mutex> lock = halLock();
+  halGnssReceiveLocked(port, static_cast<const uint8_t *>(src), size);
+  return (int)size;
+}
+
+esp_err_t uart_wait_tx_done(uart_port_t port, TickType_t wait) {
+  (void)port;
+  (void)wait;
+  return ESP_OK;
+}
+
+esp_err_t uart_get_buffered_data_len(uart_port_t port, size_t *size) {
+  HalUart *uart = uartFor(port);
+  if (uart == nullptr) {
+    return ESP_FAIL;
+  }
+  std::unique_lock<std::mutex> lock = halLock();
+  *size = uart->rx.size();
+  return ESP_OK;
+}
+
+esp_err_t uart_flush_input(uart_port_t port) {
+  HalUart *uart = uartFor(port);
+  if (uart == nullptr) {
+    return ESP_FAIL;
+  }
+  std::unique_lock<std::mutex> lock = halLock();
+  uart->readCount += uart->rx.size();
+  uart->rx.clear();
+  return ESP_OK;
+}
+
+esp_err_t uart_set_wakeup_threshold(uart_port_t port, int threshold) {
+  HalUart *uart = uartFor(port);
+  if (uart == nullptr) {
+    return ESP_FAIL;
+  }
+  std::unique_lock<std::mutex> lock = halLock();
+  uart->wakeThreshold = threshold;
+  return ESP_OK;
+}
+
+void halUartWakeupEnable(int port) {
+  HalUart *uart = uartFor((uart_port_t)port);
+  if (uart != nullptr) {
+    std::unique_lock<std::mutex> lock = halLock();
+    uart->wakeEnabled = true;
+  }
+}
+
+void halUartLightSleep(int64_t us) {
+  std::unique_lock<std::mutex> lock = halLock();
+  sleeping = true;
+  halWait(lock, [] { return !sleeping; }, us);
+  sleeping = false;
+}
+
+uint32_t halUartWakeups(uint64_t *lostBytes) {
+  std::unique_lock<std::mutex> lock = halLock();
+  if (lostBytes != nullptr) {
+    *lostBytes = wakeLostBytes;
+  }
+  return uartWakeups;
+}
@@ -0,0 +1,500 @@
+// Porównanie szybkości parserów NMEA na hoście: NmeaParser (całe zdanie)
+// i TinyGPSPlus::encode (znak po znaku) na tym samym zapisie.
+// hostBenchScreen: koszt formatowania klatki zegara - szablony ScreenFormat
+// wobec dawnej ścieżki strftime/Print.
+// hostBenchTime: koszt now()/nowMicros() z Time-master wobec dawnej pętli
+// po sekundach, też pierwszego wywołania po wielodniowej przerwie.
+// hostStressTime: wątki czytające Time-master w trakcie ciągłych zapisów.
+// hostBenchSuite: wszystkie pomiary naraz, NMEA z wygenerowanej godziny paczek.
+// Wyniki jako CSV na stdout (benchResult), opis na stderr.
+
+#include <atomic>
+#include <chrono>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <TimeLib.h>
+#include <TinyGPS++.h>
+#include <Wire.h>
+
+#include "Hal.h"
+#include "HostBench.h"
+#include "LcdBuffer.h"
+#include "LocalClock.h"
+#include "NmeaParser.h"
+#include "ScreenFormat.h"
+#include "esp_timer.h"
+
+static FILE *benchOut = stdout;
+static bool benchHeader = false;
+
+void benchOutput(FILE *out) {
+  benchOut = out;
+  benchHeader = false;
+}
+
+void benchResult(const char *bench, const char *metric, double value, const char *unit) {
+  if (!benchHeader) {
+    fprintf(benchOut, "bench,metric,value,unit\n");
+    benchHeader = true;
+  }
+  fprintf(benchOut, "%s,%s,%.6g,%s\n", bench, metric, value, unit);
+  fflush(benchOut);
+}
+
+// Łączny czas kilku przebiegów; zwraca zdania/s
+template <class Parse>
+static double measure(const std::vector<std::string> &lines, int passes, Parse parse) {
+  std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+  for (int pass = 0; pass < passes; pass++) {
+    for (const std::string &line : lines) {
+      parse(line);
+    }
+  }
+  double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+  return (double)lines.size() * passes / seconds;
+}
+
+// NmeaParser i TinyGPSPlus::encode na tych samych zdaniach
+static void benchNmea(const std::vector<std::string> &lines, int passes) {
+  size_t bytes = 0;
+  for (const std::string &line : lines) {
+    bytes += line.size();
+  }
+
+  NmeaParser parser;
+  double parserRate = measure(lines, passes, [&parser](const std::string &line) {
+    parser.encode(line.data(), line.size());
+  });
+
+  TinyGPSPlus tiny;
+  double tinyRate = measure(lines, passes, [&tiny](const std::string &line) {
+    for (char c : line) {
+      tiny.encode(c);
+    }
+  });
+
+  fprintf(stderr, "[bench] %zu zdań x %d\n", lines.size(), passes);
+  fprintf(stderr, "[bench] NmeaParser    %10.0f zdań/s (sumy: %lu dobre, %lu złe)\n", parserRate,
+          (unsigned long)parser.passedChecksum(), (unsigned long)parser.failedChecksum());
+  fprintf(stderr, "[bench] TinyGPSPlus   %10.0f zdań/s (sumy: %lu dobre, %lu złe)\n", tinyRate,
+          (unsigned long)tiny.passedChecksum(), (unsigned long)tiny.failedChecksum());
+  fprintf(stderr, "[bench] przyspieszenie %.1fx\n", parserRate / tinyRate);
+  double sentenceBytes = (double)bytes / lines.size();
+  benchResult("nmea", "sentences", (double)lines.size(), "count");
+  benchResult("nmea", "nmeaparser", parserRate, "sentences/s");
+  benchResult("nmea", "nmeaparser_per_byte", 1e9 / (parserRate * sentenceBytes), "ns");
+  benchResult("nmea", "tinygps_encode", tinyRate, "sentences/s");
+  benchResult("nmea", "tinygps_encode_per_byte", 1e9 / (tinyRate * sentenceBytes), "ns");
+  benchResult("nmea", "tinygps_failed_checksum", (double)tiny.failedChecksum(), "count");
+}
+
+int hostBench(const char *path, int passes) {
+  FILE *file = fopen(path, "r");
+  if (file == nullptr) {
+    fprintf(stderr, "[bench] nie można otworzyć %s\n", path);
+    return 2;
+  }
+  std::vector<std::string> lines;
+  char buffer[256];
+  while (fgets(buffer, sizeof(buffer), file) != nullptr) {
+    std::string line(buffer);
+    if (line.find('$') == 0) {
+      if (line.back() != '\n') {
+        line += "\r\n";
+      }
+      lines.push_back(line);
+    }
+  }
+  fclose(file);
+  if (lines.empty()) {
+    fprintf(stderr, "[bench] brak zdań w %s\n", path);
+    return 2;
+  }
+
+  benchNmea(lines, passes);
+  return 0;
+}
+
+
+// Klatka jak w firmware przed szablonami: strftime i Print
+static void drawWithPrint(LcdBuffer &screen, const struct tm &t, uint8_t sats) {
+  char timeStringBuff[9];
+  strftime(timeStringBuff, sizeof(timeStringBuff), "%H:%M:%S", &t);
+  screen.setCursor(0, 0);
+  screen.print(timeStringBuff);
+  screen.print(' ');
+  screen.setCursor(9, 0);
+  screen.print(" SAT:");
+  screen.print(sats < 10 ? "0" : "");
+  screen.print(sats);
+
+  char dateStringBuff[11];
+  strftime(dateStringBuff, sizeof(dateStringBuff), "%d.%m.%Y", &t);
+  screen.setCursor(0, 1);
+  screen.print(" ");
+  screen.print(dayShortStr((uint8_t)(t.tm_wday + 1)));
+  screen.print(", ");
+  screen.print(dateStringBuff);
+}
+
+// Ta sama klatka z szablonów: tylko cyfry trafiają do wierszy
+static void drawWithTemplates(LcdBuffer &screen, const struct tm &t, uint8_t sats) {
+  char *row = screen.row(0, TimeRow::text);
+  fmt2(row + TimeRow::HOUR, (uint8_t)t.tm_hour);
+  fmt2(row + TimeRow::MINUTE, (uint8_t)t.tm_min);
+  fmt2(row + TimeRow::SECOND, (uint8_t)t.tm_sec);
+  row[TimeRow::STATUS] = ' ';
+  fmt2(row + TimeRow::SATELLITES, sats);
+
+  row = screen.row(1, DateRow::text);
+  memcpy(row + DateRow::WEEKDAY, dayShortText((uint8_t)(t.tm_wday + 1)).text, 3);
+  fmt2(row + DateRow::DAY, (uint8_t)t.tm_mday);
+  fmt2(row + DateRow::MONTH, (uint8_t)(t.tm_mon + 1));
+  fmt4(row + DateRow::YEAR, (uint16_t)(t.tm_year + 1900));
+}
+
+// Łączny czas przebiegów po wszystkich klatkach; zwraca ns/klatkę
+template <class Draw>
+static double measureFrames(const std::vector<struct tm> &frames, int passes, LcdBuffer &screen, Draw draw) {
+  std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+  for (int pass = 0; pass < passes; pass++) {
+    for (size_t i = 0; i < frames.size(); i++) {
+      draw(screen, frames[i], (uint8_t)(i % 13));
+    }
+  }
+  double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+  return seconds * 1e9 / ((double)frames.size() * passes);
+}
+
+// Ścieżka ekranu; zwraca liczbę klatek, w których szablony dały inny ekran
+static size_t benchScreen(int passes) {
+  // Doba sekunda po sekundzie, z przejściem przez północ sylwestrową
+  std::vector<struct tm> frames;
+  LocalClock clock;
+  time_t utc = 1798750800;  // 2026-12-31 21:00 UTC
+  for (int i = 0; i < 86400; i++) {
+    clock.update(utc + i);
+    frames.push_back(clock.fields());
+  }
+
+  Wire.setClock(400000);
+  Hd44780 lcd(0x27, 16, 2);
+  LcdBuffer printScreen(lcd);
+  LcdBuffer templateScreen(lcd);
+
+  // Obie ścieżki muszą dawać ten sam ekran; przy okazji czas magistrali klatek
+  size_t mismatches = 0;
+  for (size_t i = 0; i < frames.size(); i++) {
+    drawWithPrint(printScreen, frames[i], (uint8_t)(i % 13));
+    drawWithTemplates(templateScreen, frames[i], (uint8_t)(i % 13));
+    for (uint8_t r = 0; r < LcdBuffer::ROWS; r++) {
+      if (memcmp(printScreen.text(r), templateScreen.text(r), LcdBuffer::COLS) != 0) {
+        mismatches++;
+        break;
+      }
+    }
+    templateScreen.flush();
+  }
+  LcdStats bus = templateScreen.stats();
+  double lcdBytes = (double)(bus.chars + bus.commands) / bus.flushes;
+  // LiquidCrystal_I2C: 3 transmisje (adres + 1 bajt) na półbajt, 2 półbajty na bajt
+  double perByteUs = 6 * (9.0 * 2 + 2) * 1e6 / Wire.getClock();
+
+  double printNs = measureFrames(frames, passes, printScreen, drawWithPrint);
+  double templateNs = measureFrames(frames, passes, templateScreen, drawWithTemplates);
+  // Cała ścieżka klatki: szablony i flush() przez Hd44780 do modelu LCD
+  double renderNs = measureFrames(frames, passes, templateScreen, [](LcdBuffer &screen, const struct tm &t,
+                                                                      uint8_t sats) {
+    drawWithTemplates(screen, t, sats);
+    screen.flush();
+  });
+
+  fprintf(stderr, "[bench] %zu klatek x %d, różne ekrany: %zu\n", frames.size(), passes, mismatches);
+  fprintf(stderr, "[bench] strftime/Print %8.1f ns/klatkę\n", printNs);
+  fprintf(stderr, "[bench] szablony       %8.1f ns/klatkę\n", templateNs);
+  fprintf(stderr, "[bench] szablony+flush %8.1f ns/klatkę\n", renderNs);
+  fprintf(stderr, "[bench] przyspieszenie %.1fx\n", printNs / templateNs);
+  fprintf(stderr, "[bench] I2C %lu kHz, %.1f bajtów HD44780/klatkę\n", (unsigned long)(Wire.getClock() / 1000),
+          lcdBytes);
+  fprintf(stderr, "[bench] magistrala Hd44780          %8.1f us/klatkę (maks. %lu)\n",
+          (double)bus.sumBusUs / bus.flushes, (unsigned long)bus.maxBusUs);
+  fprintf(stderr, "[bench] magistrala LiquidCrystal_I2C %7.1f us/klatkę (szacunek, bez opóźnień)\n",
+          lcdBytes * perByteUs);
+  benchResult("render", "frames", (double)frames.size(), "count");
+  benchResult("render", "mismatches", (double)mismatches, "count");
+  benchResult("render", "strftime_print", printNs, "ns/frame");
+  benchResult("render", "templates", templateNs, "ns/frame");
+  benchResult("render", "templates_flush", renderNs, "ns/frame");
+  benchResult("render", "hd44780_bytes", lcdBytes, "bytes/frame");
+  benchResult("render", "hd44780_bus", (double)bus.sumBusUs / bus.flushes, "us/frame");
+  benchResult("render", "hd44780_bus_max", (double)bus.maxBusUs, "us/frame");
+  benchResult("render", "liquidcrystal_i2c_bus_estimate", lcdBytes * perByteUs, "us/frame");
+  return mismatches;
+}
+
+int hostBenchScreen(int passes) {
+  return benchScreen(passes) == 0 ? 0 : 1;
+}
+
+// Dawne now(): sekunda po sekundzie od ostatniego wywołania
+static uint32_t oldSysTime = 0;
+static uint32_t oldPrevMillis = 0;
+
+static time_t oldNow(uint32_t ms) {
+  while (ms - oldPrevMillis >= 1000) {
+    oldSysTime++;
+    oldPrevMillis += 1000;
+  }
+  return (time_t)oldSysTime;
+}
+
+// Licznik sterowany przez test
+static int64_t fakeCounterUs = 0;
+
+static int64_t fakeCounter() {
+  return fakeCounterUs;
+}
+
+template <class Read>
+static double measureCalls(int calls, Read read) {
+  volatile int64_t sink = 0;
+  std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+  for (int i = 0; i < calls; i++) {
+    sink = sink + (int64_t)read();
+  }
+  double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+  return seconds * 1e9 / calls;
+}
+
+// Koszt now()/nowMicros() na prawdziwym liczniku (esp_timer na hoście)
+static void benchNow(int calls) {
+  const int64_t start = 1780308000LL * 1000000 + 250000;  // 2026-06-01 10:00:00.25 UTC
+  setMicrosCounter(0);
+  setTimeMicros(start);
+  oldSysTime = 0;
+  oldPrevMillis = millis();
+  double oldNs = measureCalls(calls, [] { return oldNow(millis()); });
+  double nowNs = measureCalls(calls, [] { return now(); });
+  double microsNs = measureCalls(calls, [] { return nowMicros(); });
+  double counterNs = measureCalls(calls, [] { return esp_timer_get_time(); });
+  fprintf(stderr, "[bench] %d wywołań\n", calls);
+  fprintf(stderr, "[bench] licznik (esp_timer)   %6.1f ns\n", counterNs);
+  fprintf(stderr, "[bench] dawne now() (millis)  %6.1f ns\n", oldNs);
+  fprintf(stderr, "[bench] now()                 %6.1f ns\n", nowNs);
+  fprintf(stderr, "[bench] nowMicros()           %6.1f ns\n", microsNs);
+  benchResult("time", "esp_timer_get_time", counterNs, "ns");
+  benchResult("time", "old_now", oldNs, "ns");
+  benchResult("time", "now", nowNs, "ns");
+  benchResult("time", "nowMicros", microsNs, "ns");
+}
+
+int hostBenchTime(int calls) {
+  // Pierwsze wywołanie po przerwie: dawna pętla robi jeden obrót na sekundę
+  const int64_t start = 1780308000LL * 1000000 + 250000;  // 2026-06-01 10:00:00.25 UTC
+  const int64_t day = 86400LL * 1000000;
+  setMicrosCounter(fakeCounter);
+  setTimeMicros(start);
+  oldSysTime = 0;
+  oldPrevMillis = 0;
+  std::chrono::steady_clock::time_point begin = std::chrono::steady_clock::now();
+  oldNow(3 * 86400 * 1000);
+  double oldGapUs = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count() * 1e6;
+  begin = std::chrono::steady_clock::now();
+  fakeCounterUs += 3 * day;
+  now();
+  double newGapUs = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count() * 1e6;
+  fprintf(stderr, "[bench] pierwsze now() po 3 dniach: pętla %.1f us, nowy zegar %.3f us\n", oldGapUs, newGapUs);
+  benchResult("time", "first_now_after_3_days_old_loop", oldGapUs, "us");
+  benchResult("time", "first_now_after_3_days", newGapUs, "us");
+
+  benchNow(calls);
+  return 0;
+}
+
+// Koszt wywołania na chwilach rozrzuconych po całym zakresie 1970-2225
+template <class Call>
+static double nsPerCall(const std::vector<time_t> &times, int passes, Call call) {
+  std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+  for (int pass = 0; pass < passes; pass++) {
+    for (time_t t : times) {
+      call(t);
+    }
+  }
+  double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+  return seconds * 1e9 / ((double)times.size() * passes);
+}
+
+void benchTimeLib(int passes) {
+  std::mt19937 random(1970);
+  std::uniform_int_distribution<int64_t> anyTime(0, 8078572799LL);   // do 2225-12-31 23:59:59
+  std::vector<time_t> times;
+  for (int i = 0; i < 4096; i++) {
+    times.push_back((time_t)anyTime(random));
+  }
+  std::vector<tmElements_t> elements(times.size());
+  for (size_t i = 0; i < times.size(); i++) {
+    breakTime(times[i], elements[i]);
+  }
+  volatile int64_t sink = 0;
+  double breakNs = nsPerCall(times, passes, [&sink](time_t t) {
+    tmElements_t fields;
+    breakTime(t, fields);
+    sink = sink + fields.Day;
+  });
+  double gmtimeNs = nsPerCall(times, passes, [&sink](time_t t) {
+    struct tm fields;
+    gmtime_r(&t, &fields);
+    sink = sink + fields.tm_mday;
+  });
+  size_t next = 0;
+  double makeNs = nsPerCall(times, passes, [&sink, &elements, &next](time_t) {
+    sink = sink + makeTime(elements[next]);
+    next = next + 1 == elements.size() ? 0 : next + 1;
+  });
+  fprintf(stderr, "[bench] %zu chwil x %d\n", times.size(), passes);
+  fprintf(stderr, "[bench] breakTime()   %6.1f ns\n", breakNs);
+  fprintf(stderr, "[bench] gmtime_r()    %6.1f ns\n", gmtimeNs);
+  fprintf(stderr, "[bench] makeTime()    %6.1f ns\n", makeNs);
+  benchResult("timelib", "breakTime", breakNs, "ns");
+  benchResult("timelib", "gmtime_r", gmtimeNs, "ns");
+  benchResult("timelib", "makeTime", makeNs, "ns");
+}
+
+int hostBenchSuite(int passes) {
+  // Godzina paczek odbiornika sekunda po sekundzie
+  std::vector<std::string> lines;
+  for (time_t t = 1780308000; t < 1780308000 + 3600; t++) {
+    std::string burst = hostNmeaBurst(t);
+    size_t start = 0;
+    size_t end;
+    while ((end = burst.find('\n', start)) != std::string::npos) {
+      lines.push_back(burst.substr(start, end + 1 - start));
+      start = end + 1;
+    }
+  }
+  benchNmea(lines, passes);
+  benchTimeLib(passes * 20);
+  size_t mismatches = benchScreen(passes);
+  benchNow(passes * 100000);
+  return mismatches == 0 ? 0 : 1;
+}
+
+// Dwa zamrożone liczniki: zmiana licznika nie zmienia czasu, ale licznik
+// z jednej kopii stanu i kotwica z drugiej dają czas przesunięty o różnicę
+static const int64_t STRESS_COUNTER_A = 1000000000000LL;
+static const int64_t STRESS_COUNTER_B = 2000000000000LL;
+
+static int64_t stressCounterA() {
+  return STRESS_COUNTER_A;
+}
+
+static int64_t stressCounterB() {
+  return STRESS_COUNTER_B;
+}
+
+struct StressResult {
+  uint64_t reads = 0;
+  uint64_t torn = 0;     // czas spoza dwóch poprawnych wartości
+  uint64_t fields = 0;   // pola hour(t)... niezgodne z t z now()
+};
+
+static bool sameFields(time_t t, const TimeFields &expected) {
+  return hour(t) == expected.hour() && minute(t) == expected.minute() && second(t) == expected.second() &&
+         day(t) == expected.day() && month(t) == expected.month() && year(t) == expected.year() &&
+         weekday(t) == expected.weekday();
+}
+
+int hostStressTime(int maxThreads, double seconds) {
+  // Pisarz przełącza licznik i przestawia zegar o 3 dni 5:07:11 tam i z powrotem;
+  // każdy spójny odczyt to dokładnie start albo start + krok
+  const int64_t start = 1780308000LL * 1000000 + 250000;
+  const int64_t step = ((3 * 24 + 5) * 3600LL + 7 * 60 + 11) * 1000000;
+  const TimeFields fieldsA((time_t)(start / 1000000));
+  const TimeFields fieldsB((time_t)((start + step) / 1000000));
+  bool ok = true;
+
+  fprintf(stderr, "[stress] wątki  odczyty/s   na wątek/s  zapisy/s  rozdarte  złe pola\n");
+  for (int threads = 1; threads <= maxThreads; threads *= 2) {
+    setMicrosCounter(stressCounterA);
+    setTimeMicros(start);
+    std::atomic<bool> stop(false);
+    std::atomic<uint64_t> writes(0);
+    std::vector<StressResult> results(threads);
+
+    std::thread writer([&] {
+      bool shifted = false;
+      while (!stop.load(std::memory_order_relaxed)) {
+        setMicrosCounter(stressCounterB);
+        setMicrosCounter(stressCounterA);
+        adjustTimeMicros(shifted ? -step : step);
+        shifted = !shifted;
+        writes += 3;
+      }
+    });
+    std::vector<std::thread> readers;
+    for (int i = 0; i < threads; i++) {
+      readers.emplace_back([&, i] {
+        StressResult &result = results[i];
+        while (!stop.load(std::memory_order_relaxed)) {
+          int64_t micros = nowMicros();
+          if (micros != start && micros != start + step) {
+            result.torn++;
+          }
+          // Pola chwili z zegara, który pisarz właśnie przestawia: hour(t)...
+          // muszą pasować do tej z dwóch chwil, którą zwróciło now()
+          time_t t = now();
+          if (t == fieldsA.time()) {
+            result.fields += !sameFields(t, fieldsA);
+          } else if (t == fieldsB.time()) {
+            result.fields += !sameFields(t, fieldsB);
+          } else {
+            result.torn++;
+          }
+          // Bez argumentu każde pole czyta zegar osobno: jedna z dwóch chwil
+          int h = hour();
+          if (h != fieldsA.hour() && h != fieldsB.hour()) {
+            result.fields++;
+          }
+          int d = day();
+          if (d != fieldsA.day() && d != fieldsB.day()) {
+            result.fields++;
+          }
+          result.reads++;
+        }
+      });
+    }
+    std::this_thread::sleep_for(std::chrono::duration<double>(seconds));
+    stop = true;
+    writer.join();
+    for (std::thread &reader : readers) {
+      reader.join();
+    }
+
+    StressResult total;
+    for (const StressResult &result : results) {
+      total.reads += result.reads;
+      total.torn += result.torn;
+      total.fields += result.fields;
+    }
+    ok &= total.torn == 0 && total.fields == 0;
+    fprintf(stderr, "[stress] %5d %11.0f %12.0f %9.0f %9llu %9llu\n", threads, total.reads / seconds,
+            total.reads / seconds / threads, writes / seconds, (unsigned long long)total.torn,
+            (unsigned long long)total.fields);
+    char metric[32];
+    snprintf(metric, sizeof(metric), "reads_threads_%d", threads);
+    benchResult("stress_time", metric, total.reads / seconds, "1/s");
+    snprintf(metric, sizeof(metric), "writes_threads_%d", threads);
+    benchResult("stress_time", metric, writes / seconds, "1/s");
+    snprintf(metric, sizeof(metric), "torn_threads_%d", threads);
+    benchResult("stress_time", metric, (double)total.torn, "count");
+    snprintf(metric, sizeof(metric), "bad_fields_threads_%d", threads);
+    benchResult("stress_time", metric, (double)total.fields, "count");
+  }
+  setMicrosCounter(0);
+  fprintf(stderr, "[stress] procesory: %u\n", std::thread::hardware_concurrency());
+  benchResult("stress_time", "cpus", std::thread::hardware_concurrency(), "count");
+  return ok ? 0 : 1;
+}
@@ -0,0 +1,32 @@
+#pragma once
+
+// Tryby programu hosta poza symulacją: pomiary (HostBench.cpp) i testy
+// z oczekiwanym wynikiem (HostTest.cpp); wybierane w HostMain.
+
+#include <stdio.h>
+#include <time.h>
+
+#include <string>
+
+// Wyniki pomiarów: wiersze CSV "bench,metric,value,unit" (nagłówek przed
+// pierwszym) na `out`, domyślnie stdout; opis dla człowieka idzie na stderr
+void benchOutput(FILE *out);
+void benchResult(const char *bench, const char *metric, double value, const char *unit);
+
+int hostBench(const char *path, int passes);
+int hostBenchScreen(int passes);
+int hostBenchTime(int calls);
+int hostBenchSuite(int passes);
+int hostStressTime(int maxThreads, double seconds);
+
+// Koszt breakTime()/makeTime()/gmtime_r() na chwilach z lat 1970-2225
+void benchTimeLib(int passes);
+
+int hostTestGpsTime();
+int hostTestNmea();
+int hostTestTime();
+int hostTestTimeLib(int passes);
+int hostTestTimezone(const char *zone);
+
+// Paczka odbiornika (RMC, GGA, GSA z sumami kontrolnymi) dla sekundy UTC t
+std::string hostNmeaBurst(time_t t);
@@ -0,0 +1,515 @@
+// Punkt wejścia [env:native]: setup()/loop() na hoście.
+// Bez argumentów dane NMEA ze stdin trafiają na UART1 w tempie ustawionej
+// prędkości łącza. Z --replay PLIK zapis jest odtwarzany w czasie wirtualnym:
+// przebieg jest deterministyczny i trwa ułamek czasu rzeczywistego, a na
+// końcu wypisywany jest raport ([sim]) z błędem wyświetlanego czasu.
+// Z --receiver DATA zamiast zapisu nadaje model odbiornika (HalGnss),
+// który wykonuje polecenia konfiguracyjne firmware.
+// --bench PLIK porównuje szybkość NmeaParser i TinyGPSPlus (HostBench).
+// --bench-screen mierzy koszt formatowania klatki zegara (HostBench).
+// --bench-suite wykonuje wszystkie pomiary HostBench, --bench-loop w symulacji
+// mierzy czas CPU iteracji loop(); wyniki jako CSV na stdout.
+// --test-* to testy z oczekiwanym wynikiem (HostTest), kod wyjścia 0 - zgodne.
+
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/time.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "GpsTime.h"
+#include "Hal.h"
+#include "HostBench.h"
+#include "TimeLocale.h"
+#include "Timezone.h"
+
+void setup();
+void loop();
+
+static void feedStdin() {
+  int c;
+  while ((c = getchar()) != EOF) {
+    uint8_t byte = (uint8_t)c;
+    halUartInject(UART_NUM_1, &byte, 1);
+    halSleepUs(10000000LL / halUartBaud(UART_NUM_1));  // 10 bitów na znak
+  }
+}
+
+// Wypisuje ekran LCD, gdy się zmienił; true - zmiana
+static bool printLcd(bool enabled) {
+  static std::string last;
+  if (halLcdRow(0) == nullptr) {
+    return false;
+  }
+  std::string rows = std::string("|") + halLcdRow(0) + "|" + halLcdRow(1) + "|";
+  std::string text;
+  for (char c : rows) {
+    if ((uint8_t)c < 8) {
+      // Znak z CGRAM: litera z lokalizacji Time-master
+      const char *letter = timeLocaleGlyphUtf8(c);
+      text += letter != nullptr ? letter : "?";
+    } else {
+      text += c;
+    }
+  }
+  if (text == last) {
+    return false;
+  }
+  last = text;
+  if (enabled) {
+    if (halSimActive()) {
+      fprintf(stderr, "[lcd %10.3f] %s\n", halSimMicros() / 1e6, text.c_str());
+    } else {
+      fprintf(stderr, "[lcd] %s\n", text.c_str());
+    }
+  }
+  return true;
+}
+
+// --- Odtwarzanie zapisu NMEA ---
+
+struct ReplayOptions {
+  const char *file = nullptr;
+  const char *receiverStart = nullptr;   // RRRR-MM-DDTGG:MM:SS (UTC)
+  double durationSeconds = 60;
+  double tailSeconds = 5;
+  double ppm = 0;                        // błąd kwarcu firmware
+  uint32_t baud = 9600;
+  bool lcd = false;
+  bool usbPty = false;                   // Serial na pseudoterminalu (TimeLink)
+  bool benchLoop = false;                // CSV z kosztem loop(), raport na stderr
+};
+
+// Czas UTC odtwarzanego zapisu w chwili halSimMicros() (znany po pierwszym RMC z datą)
+struct Truth {
+  bool known = false;
+  int64_t utcAtZeroUs = 0;   // UTC [us] w chwili 0 czasu prawdziwego
+};
+
+static Truth truth;
+
+struct ReplayStats {
+  int samples = 0;
+  int wrongSecond = 0;
+  double sumLag = 0;
+  double maxLag = 0;
+  double sumClockError = 0;
+  double maxClockError = 0;
+  int64_t firstDisplayUs = -1;
+  int restarts = 0;
+  int steadyFrames = 0;    // ramki LCD po pierwszym czasie na ekranie
+  int excessWrites = 0;    // znaki wysłane w nich bez zmiany (halLcdEndFrame)
+};
+
+static ReplayStats replayStats;
+
+// Pole o numerze `index` zdania NMEA (0 - nagłówek)
+static std::string nmeaField(const std::string &sentence, int index) {
+  size_t start = 0;
+  for (int i = 0; i < index; i++) {
+    start = sentence.find(',', start);
+    if (start == std::string::npos) {
+      return "";
+    }
+    start++;
+  }
+  size_t end = sentence.find_first_of(",*", start);
+  return sentence.substr(start, end == std::string::npos ? std::string::npos : end - start);
+}
+
+// Typ zdania bez identyfikatora systemu ($GPRMC, $GNRMC -> RMC)
+static std::string nmeaType(const std::string &sentence) {
+  std::string head = nmeaField(sentence, 0);
+  return head.size() >= 6 ? head.substr(3, 3) : head;
+}
+
+// Pole czasu hhmmss.ss -> sekundy doby; < 0, gdy puste
+static double nmeaTimeOfDay(const std::string &field) {
+  if (field.size() < 6) {
+    return -1;
+  }
+  return atoi(field.substr(0, 2).c_str()) * 3600 + atoi(field.substr(2, 2).c_str()) * 60 +
+         atof(field.substr(4).c_str());
+}
+
+static int64_t nmeaUtcSeconds(int year, int month, int day) {
+  return daysFromCivil(year, month, day) * 86400;
+}
+
+// Dzieli zapis na paczki (jedna sekunda odbiornika) i planuje je na UART1.
+// Nowa paczka zaczyna się od powtórzonego typu zdania; jej chwilę wyznacza
+// pole czasu (przerwy w zapisie to przerwy w odbiorze), a bez czasu +1 s.
+static int64_t scheduleReplay(const ReplayOptions &options) {
+  FILE *file = fopen(options.file, "r");
+  if (file == nullptr) {
+    fprintf(stderr, "[sim] nie można otworzyć %s\n", options.file);
+    exit(2);
+  }
+
+  const int64_t charUs = 10000000LL / options.baud;
+  std::vector<std::string> types;
+  double burstSecond = 0;       // chwila paczki względem pierwszej [s]
+  double burstTimeOfDay = -1;   // czas doby paczki z pola czasu
+  int64_t burstUs = 0;          // początek nadawania paczki (czas prawdziwy)
+  int64_t lineUs = 0;           // koniec ostatniego zdania
+  bool first = true;
+  int sentences = 0;
+  char buffer[256];
+
+  while (fgets(buffer, sizeof(buffer), file) != nullptr) {
+    std::string line(buffer);
+    while (!line.empty() && (line.back() == '\n' || line.back() == '\r')) {
+      line.pop_back();
+    }
+    size_t dollar = line.find('$');
+    if (dollar == std::string::npos) {
+      continue;
+    }
+    line = line.substr(dollar);
+
+    std::string type = nmeaType(line);
+    double timeOfDay = (type == "RMC" || type == "GGA" || type == "ZDA" || type == "GLL")
+                         ? nmeaTimeOfDay(nmeaField(line, type == "GLL" ? 5 : 1)) : -1;
+    bool repeated = false;
+    for (const std::string &seen : types) {
+      repeated = repeated || seen == type;
+    }
+    bool newTime = timeOfDay >= 0 && burstTimeOfDay >= 0 && fabs(timeOfDay - burstTimeOfDay) > 1e-3;
+
+    if (first || repeated || newTime) {
+      if (!first) {
+        double step = 1;
+        if (timeOfDay >= 0 && burstTimeOfDay >= 0) {
+          step = fmod(timeOfDay - burstTimeOfDay + 86400, 86400);
+        }
+        burstSecond += step;
+      }
+      types.clear();
+      burstTimeOfDay = timeOfDay;
+      burstUs = 1000000 + (int64_t)llround(burstSecond * 1e6) + GPS_RECEIVER_LATENCY_US;
+      lineUs = burstUs;
+      first = false;
+    }
+    types.push_back(type);
+    if (burstTimeOfDay < 0) {
+      burstTimeOfDay = timeOfDay;
+    }
+
+    // Kotwica czasu prawdziwego: pierwsze RMC z czasem i datą
+    if (!truth.known && type == "RMC" && timeOfDay >= 0) {
+      std::string date = nmeaField(line, 9);
+      if (date.size() == 6) {
+        int64_t utc = nmeaUtcSeconds(2000 + atoi(date.substr(4, 2).c_str()),
+                                     atoi(date.substr(2, 2).c_str()),
+                                     atoi(date.substr(0, 2).c_str()));
+        truth.known = true;
+        truth.utcAtZeroUs = utc * 1000000 + (int64_t)llround(timeOfDay * 1e6) -
+                            (burstUs - GPS_RECEIVER_LATENCY_US);
+      }
+    }
+
+    line += "\r\n";
+    lineUs += (int64_t)line.size() * charUs;
+    halSimSchedule(lineUs, UART_NUM_1, options.baud, (const uint8_t *)line.data(), line.size());
+    sentences++;
+  }
+  fclose(file);
+  fprintf(stderr, "[sim] %d zdań, %.1f s zapisu\n", sentences, lineUs / 1e6);
+  return lineUs;
+}
+
+// Model odbiornika zamiast zapisu; zwraca koniec przebiegu
+static int64_t startReceiver(const ReplayOptions &options) {
+  int year, month, day, hour, minute, second;
+  if (sscanf(options.receiverStart, "%d-%d-%dT%d:%d:%d",
+             &year, &month, &day, &hour, &minute, &second) != 6) {
+    fprintf(stderr, "[sim] zły czas startu %s\n", options.receiverStart);
+    exit(2);
+  }
+  int64_t utc = nmeaUtcSeconds(year, month, day) + hour * 3600 + minute * 60 + second;
+  halGnssBegin(UART_NUM_1, (time_t)utc);
+  truth.known = true;
+  truth.utcAtZeroUs = utc * 1000000 - 1000000;
+  return (int64_t)(options.durationSeconds * 1e6);
+}
+
+static int64_t truthUtcUs() {
+  return truth.utcAtZeroUs + halSimMicros();
+}
+
+// Odchyłka czasu na LCD od sekundy prawdziwej uznawana jeszcze za poprawną [s]
+static const double WRONG_SECOND_TOLERANCE = 0.05;
+
+// Porównuje czas na LCD (HH:MM:SS w wierszu 0) z czasem prawdziwym
+static void sampleDisplay() {
+  if (halLcdRow(0) == nullptr || !truth.known) {
+    return;
+  }
+  std::string row = halLcdRow(0);
+  int h, m, s;
+  if (row.size() < 8 || row[2] != ':' || row[5] != ':' ||
+      sscanf(row.c_str(), "%2d:%2d:%2d", &h, &m, &s) != 3) {
+    return;
+  }
+  if (replayStats.firstDisplayUs < 0) {
+    replayStats.firstDisplayUs = halSimMicros();
+  }
+
+  int64_t utcUs = truthUtcUs();
+  int64_t utcSeconds = utcUs / 1000000;
+  double localOfDay = (double)(tzUtcToLocal((time_t)utcSeconds) % 86400) + (utcUs % 1000000) / 1e6;
+  double lag = fmod(localOfDay - (h * 3600 + m * 60 + s) + 86400 + 43200, 86400) - 43200;
+
+  struct timeval tv;
+  gettimeofday(&tv, nullptr);
+  double clockError = ((int64_t)tv.tv_sec * 1000000 + tv.tv_usec - utcUs) / 1e6;
+
+  replayStats.samples++;
+  replayStats.sumLag += lag;
+  replayStats.maxLag = fmax(replayStats.maxLag, fabs(lag));
+  replayStats.sumClockError += clockError;
+  replayStats.maxClockError = fmax(replayStats.maxClockError, fabs(clockError));
+  if (lag < -WRONG_SECOND_TOLERANCE || lag >= 1 + WRONG_SECOND_TOLERANCE) {
+    replayStats.wrongSecond++;
+  }
+}
+
+static void printTime(const char *label, int64_t us) {
+  if (us < 0) {
+    printf("[sim] %-22s -\n", label);
+  } else {
+    printf("[sim] %-22s %.3f s\n", label, us / 1e6);
+  }
+}
+
+static bool lcdEnabled = false;
+
+// Ekran kompletny (wątek, który go zmienił, zaczyna czekać)
+static void onLcdChanged() {
+  static std::mutex lock;
+  std::lock_guard<std::mutex> guard(lock);
+  bool changed = printLcd(lcdEnabled);
+  int excess = halLcdEndFrame();
+  if (!halSimActive()) {
+    return;
+  }
+  // Ramki po pierwszym czasie na ekranie: tylko zmienione cyfry
+  if (replayStats.firstDisplayUs >= 0 && excess >= 0) {
+    replayStats.steadyFrames++;
+    replayStats.excessWrites += excess;
+  }
+  if (changed) {
+    sampleDisplay();
+  }
+}
+
+// Czas CPU wątku pętli w każdej iteracji loop() (--bench-loop)
+static std::vector<int64_t> loopCpuNs;
+
+static void reportLoopBench() {
+  std::vector<int64_t> sorted = loopCpuNs;
+  std::sort(sorted.begin(), sorted.end());
+  double sum = 0;
+  for (int64_t ns : sorted) {
+    sum += (double)ns;
+  }
+  size_t n = sorted.size();
+  double seconds = halSimMicros() / 1e6;
+  struct timespec cpu;
+  clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &cpu);
+  benchResult("loop", "iterations", (double)n, "count");
+  benchResult("loop", "iterations_per_s", n / seconds, "1/s");
+  if (n > 0) {
+    benchResult("loop", "cpu_mean", sum / n, "ns");
+    benchResult("loop", "cpu_p50", (double)sorted[n / 2], "ns");
+    benchResult("loop", "cpu_p99", (double)sorted[n * 99 / 100], "ns");
+    benchResult("loop", "cpu_max", (double)sorted[n - 1], "ns");
+  }
+  benchResult("loop", "process_cpu", (cpu.tv_sec * 1e6 + cpu.tv_nsec / 1e3) / seconds, "us/s");
+}
+
+static void printReport() {
+  int64_t firstSetUs;
+  int sets = halClockSets(&firstSetUs);
+  printf("[sim] czas wirtualny       %.3f s\n", halSimMicros() / 1e6);
+  printTime("pierwsze ustawienie", firstSetUs);
+  printf("[sim] ustawień zegara      %d\n", sets);
+  printTime("pierwszy czas na LCD", replayStats.firstDisplayUs);
+  if (replayStats.samples > 0) {
+    printf("[sim] odświeżeń LCD        %d\n", replayStats.samples);
+    printf("[sim] opóźnienie LCD       śr. %.3f s, maks. %.3f s\n",
+           replayStats.sumLag / replayStats.samples, replayStats.maxLag);
+    printf("[sim] błąd zegara          śr. %+.6f s, maks. %.6f s\n",
+           replayStats.sumClockError / replayStats.samples, replayStats.maxClockError);
+    printf("[sim] zła sekunda na LCD   %d\n", replayStats.wrongSecond);
+  }
+  printf("[sim] restartów            %d\n", replayStats.restarts);
+
+  double seconds = halSimMicros() / 1e6;
+  struct timespec cpu;
+  clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &cpu);
+  HalLcdCounters lcd = halLcdCounters();
+  printf("[sim] LCD I2C              %.0f B/s, %.1f transakcji/s, %.1f znaków/s (zmienionych %.1f/s)\n",
+         lcd.i2cBytes / seconds, lcd.transactions / seconds, lcd.cellWrites / seconds,
+         lcd.cellChanges / seconds);
+  printf("[sim] zbędne zapisy LCD    %d (ramek ustalonych %d)\n", replayStats.excessWrites,
+         replayStats.steadyFrames);
+  printf("[sim] bajty UART           %llu (%.0f B/s, prędkość %lu)\n",
+         (unsigned long long)halUartRxBytes(UART_NUM_1), halUartRxBytes(UART_NUM_1) / seconds,
+         (unsigned long)halUartBaud(UART_NUM_1));
+  uint64_t wakeLost = 0;
+  uint32_t wakeups = halUartWakeups(&wakeLost);
+  if (wakeups > 0) {
+    printf("[sim] pobudki z UART       %lu (utracone bajty %llu)\n", (unsigned long)wakeups,
+           (unsigned long long)wakeLost);
+  }
+  printf("[sim] CPU procesu          %.1f us/s\n",
+         (cpu.tv_sec * 1e6 + cpu.tv_nsec / 1e3) / seconds);
+}
+
+static bool parseArgs(int argc, char **argv, ReplayOptions &options) {
+  for (int i = 1; i < argc; i++) {
+    bool hasValue = i + 1 < argc;
+    if (!strcmp(argv[i], "--replay") && hasValue) {
+      options.file = argv[++i];
+    } else if (!strcmp(argv[i], "--receiver") && hasValue) {
+      options.receiverStart = argv[++i];
+    } else if (!strcmp(argv[i], "--duration") && hasValue) {
+      options.durationSeconds = atof(argv[++i]);
+    } else if (!strcmp(argv[i], "--tail") && hasValue) {
+      options.tailSeconds = atof(argv[++i]);
+    } else if (!strcmp(argv[i], "--baud") && hasValue) {
+      options.baud = (uint32_t)atol(argv[++i]);
+    } else if (!strcmp(argv[i], "--ppm") && hasValue) {
+      options.ppm = atof(argv[++i]);
+    } else if (!strcmp(argv[i], "--lcd")) {
+      options.lcd = true;
+    } else if (!strcmp(argv[i], "--usb-pty")) {
+      options.usbPty = true;
+    } else if (!strcmp(argv[i], "--bench-loop")) {
+      options.benchLoop = true;
+    } else {
+      fprintf(stderr, "użycie: %s [--replay PLIK [--tail S] [--baud N] | "
+                      "--receiver RRRR-MM-DDTGG:MM:SS [--duration S]] [--ppm P] [--lcd] [--usb-pty] [--bench-loop]\n"
+                      "       %s --bench PLIK [PRZEBIEGI]\n"
+                      "       %s --bench-screen [PRZEBIEGI]\n"
+                      "       %s --bench-time [WYWOŁANIA]\n"
+                      "       %s --bench-suite [PRZEBIEGI]\n"
+                      "       %s --stress-time [WĄTKI] [SEKUNDY]\n"
+                      "       %s --test-gps-time\n"
+                      "       %s --test-nmea\n"
+                      "       %s --test-time\n"
+                      "       %s --test-timelib [PRZEBIEGI]\n"
+                      "       %s --test-timezone [STREFA]\n",
+              argv[0], argv[0], argv[0], argv[0], argv[0], argv[0], argv[0], argv[0], argv[0], argv[0], argv[0]);
+      return false;
+    }
+  }
+  return options.baud > 0;
+}
+
+int main(int argc, char **argv) {
+  if (argc >= 3 && !strcmp(argv[1], "--bench")) {
+    return hostBench(argv[2], argc >= 4 ? atoi(argv[3]) : 1000);
+  }
+  if (argc >= 2 && !strcmp(argv[1], "--bench-screen")) {
+    return hostBenchScreen(argc >= 3 ? atoi(argv[2]) : 20);
+  }
+  if (argc >= 2 && !strcmp(argv[1], "--bench-time")) {
+    return hostBenchTime(argc >= 3 ? atoi(argv[2]) : 10000000);
+  }
+  if (argc >= 2 && !strcmp(argv[1], "--bench-suite")) {
+    return hostBenchSuite(argc >= 3 ? atoi(argv[2]) : 20);
+  }
+  if (argc >= 2 && !strcmp(argv[1], "--test-gps-time")) {
+    return hostTestGpsTime();
+  }
+  if (argc >= 2 && !strcmp(argv[1], "--test-nmea")) {
+    return hostTestNmea();
+  }
+  if (argc >= 2 && !strcmp(argv[1], "--test-time")) {
+    return hostTestTime();
+  }
+  if (argc >= 2 && !strcmp(argv[1], "--test-timelib")) {
+    return hostTestTimeLib(argc >= 3 ? atoi(argv[2]) : 200);
+  }
+  if (argc >= 2 && !strcmp(argv[1], "--test-timezone")) {
+    return hostTestTimezone(argc >= 3 ? argv[2] : "Europe/Warsaw");
+  }
+  if (argc >= 2 && !strcmp(argv[1], "--stress-time")) {
+    return hostStressTime(argc >= 3 ? atoi(argv[2]) : 8, argc >= 4 ? atof(argv[3]) : 1);
+  }
+
+  ReplayOptions options;
+  if (!parseArgs(argc, argv, options)) {
+    return 2;
+  }
+  if (options.benchLoop) {
+    // stdout tylko dla CSV; raport [sim] i Serial firmware na stderr
+    benchOutput(fdopen(dup(STDOUT_FILENO), "w"));
+    dup2(STDERR_FILENO, STDOUT_FILENO);
+  }
+  setvbuf(stdout, NULL, _IOLBF, 0);
+  if (options.usbPty) {
+    const char *path = halUsbPtyOpen();
+    if (path == nullptr) {
+      perror("[hal] pseudoterminal");
+      return 1;
+    }
+    fprintf(stderr, "[hal] USB CDC: %s\n", path);
+  }
+  halThreadStart();  // przed wątkami HAL, żeby czas wirtualny nie ruszył bez pętli głównej
+  lcdEnabled = options.lcd;
+  halSetLcdHook(onLcdChanged);
+
+  int64_t endUs = -1;
+  if (options.file != nullptr) {
+    halSimBegin(options.ppm);
+    endUs = scheduleReplay(options) + (int64_t)(options.tailSeconds * 1e6);
+  } else if (options.receiverStart != nullptr) {
+    halSimBegin(options.ppm);
+    endUs = startReceiver(options);
+  } else {
+    lcdEnabled = true;
+    std::thread(feedStdin).detach();
+  }
+
+  while (true) {
+    try {
+      setup();
+      while (true) {
+        struct timespec before;
+        clock_gettime(CLOCK_THREAD_CPUTIME_ID, &before);
+        loop();
+        if (options.benchLoop) {
+          struct timespec after;
+          clock_gettime(CLOCK_THREAD_CPUTIME_ID, &after);
+          loopCpuNs.push_back((after.tv_sec - before.tv_sec) * 1000000000LL + (after.tv_nsec - before.tv_nsec));
+        }
+        if (endUs >= 0 && halSimInputDone() && halSimMicros() >= endUs) {
+          printReport();
+          if (options.benchLoop) {
+            reportLoopBench();
+          }
+          fflush(stdout);
+          fflush(stderr);
+          _exit(0);  // zadania firmware nadal czekają w HAL
+        }
+      }
+    } catch (const HalRestart &) {
+      replayStats.restarts++;
+      if (truth.known && halSimActive()) {
+        fprintf(stderr, "[hal] ESP.restart() t=%.3f s UTC=%lld\n", halSimMicros() / 1e6,
+                (long long)(truthUtcUs() / 1000000));
+      } else {
+        fprintf(stderr, "[hal] ESP.restart()\n");
+      }
+    }
+  }
+}
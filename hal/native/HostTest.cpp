@@ -0,0 +1,433 @@
+// Testy hosta (fw --test-*): kod firmware na danych o znanym wyniku,
+// kod wyjścia 0 - wszystkie przypadki zgodne.
+// hostTestGpsTime: paczki NMEA ze znacznikiem czasu każdego bajtu, ramkowanie
+// GpsBurstFramer (też z zaległymi zdarzeniami '\n'), NmeaParser
+// i gpsBurstToTimeval(); błąd ustawionego czasu względem prawdziwej chwili
+// dla modelu opóźnienia i dla zbocza PPS.
+// hostTestNmea: NmeaParser na zdaniach z poprawną sumą, ale czasem lub datą
+// spoza zakresu (nie mogą trafić do zegara), i licznik sekund z fiksem.
+// hostTestTime: zegar Time-master (licznik sterowany przez test) po przerwach
+// od ułamka sekundy do 400 dni, po krokach i korektach stopniowych.
+// hostTestTimeLib: breakTime()/makeTime() z Time-master wobec gmtime_r()
+// dla każdego dnia 1970-2225 i koszt jednego wywołania.
+// hostTestTimezone: tabela zmian czasu z Timezone.h wobec bazy zoneinfo
+// (localtime_r, TZ=Europe/Warsaw) dla wszystkich lat tabeli.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <random>
+#include <string>
+#include <vector>
+
+#include <TimeLib.h>
+
+#include "GpsTime.h"
+#include "GpsUart.h"
+#include "HostBench.h"
+#include "NmeaParser.h"
+#include "Timezone.h"
+
+// Zdanie z sumą kontrolną i CR LF
+static std::string nmeaSentence(const char *body) {
+  uint8_t sum = 0;
+  for (const char *p = body; *p; p++) {
+    sum ^= (uint8_t)*p;
+  }
+  char tail[8];
+  snprintf(tail, sizeof(tail), "*%02X\r\n", sum);
+  return std::string("$") + body + tail;
+}
+
+std::string hostNmeaBurst(time_t t) {
+  struct tm utc;
+  gmtime_r(&t, &utc);
+  char body[128];
+  std::string burst;
+  snprintf(body, sizeof(body), "GNRMC,%02d%02d%02d.000,A,5213.0000,N,02100.0000,E,0.00,0.00,%02d%02d%02d,,,A",
+           utc.tm_hour, utc.tm_min, utc.tm_sec, utc.tm_mday, utc.tm_mon + 1, utc.tm_year % 100);
+  burst += nmeaSentence(body);
+  snprintf(body, sizeof(body), "GNGGA,%02d%02d%02d.000,5213.0000,N,02100.0000,E,1,08,1.0,100.0,M,34.0,M,,",
+           utc.tm_hour, utc.tm_min, utc.tm_sec);
+  burst += nmeaSentence(body);
+  burst += nmeaSentence("GNGSA,A,3,01,03,06,09,12,17,19,22,,,,,1.8,1.0,1.5,1");
+  return burst;
+}
+
+enum PpsMode {
+  PPS_NONE,      // wejście niepodłączone
+  PPS_EDGE,      // zbocze na początku każdej sekundy
+  PPS_STALE,     // ostatnie zbocze 2 s przed paczką
+  PPS_LATE       // zbocze w trakcie paczki (nie należy do niej)
+};
+
+struct GpsTimeCase {
+  const char *name;
+  uint32_t baud;
+  int64_t latencyUs;        // rzeczywiste opóźnienie odbiornika
+  int64_t jitterUs;         // +- rozrzut opóźnienia
+  PpsMode pps;
+  int64_t expectedErrorUs;  // oczekiwany błąd ustawionego czasu
+  int64_t toleranceUs;
+  int64_t handlerDelayUs;   // zadanie odbiorcze zajęte po pierwszym '\n' paczki
+};
+
+// Odtwarza `seconds` sekund od `start`; false przy błędzie poza tolerancją
+static bool replayGpsTime(const GpsTimeCase &c, time_t start, int seconds) {
+  const int64_t charUs = 10000000LL / c.baud;
+  const int64_t edge0Us = 5000000;   // esp_timer na pierwszym zboczu sekundy
+  std::mt19937 random(12345);
+  std::uniform_int_distribution<int64_t> jitter(-c.jitterUs, c.jitterUs);
+
+  NmeaParser parser;
+  GpsBurstFramer framer;
+  int64_t minError = INT64_MAX;
+  int64_t maxError = INT64_MIN;
+  int64_t sumError = 0;
+  int wrong = 0;
+  int synced = 0;
+
+  for (int k = 0; k < seconds; k++) {
+    time_t utc = start + k;
+    int64_t edgeUs = edge0Us + (int64_t)k * 1000000;
+    int64_t ppsUs = 0;
+    switch (c.pps) {
+      case PPS_NONE: break;
+      case PPS_EDGE: ppsUs = edgeUs + 3; break;   // obsługa przerwania
+      case PPS_STALE: ppsUs = edgeUs - 2000000; break;
+      case PPS_LATE: ppsUs = edgeUs + c.latencyUs + 2000; break;
+    }
+
+    // Bajty paczki: koniec każdego znaku co charUs od początku nadawania
+    std::string burst = hostNmeaBurst(utc);
+    std::vector<int64_t> byteUs(burst.size());
+    int64_t endUs = edgeUs + c.latencyUs + jitter(random);
+    for (size_t i = 0; i < burst.size(); i++) {
+      endUs += charUs;
+      byteUs[i] = endUs;
+    }
+    bool timeSet = false;
+    struct timeval tv = {0, 0};
+    int64_t nowUs = 0;
+    int64_t busyUntilUs = -1;
+    size_t begin = 0;
+    for (size_t i = 0; i < burst.size(); i++) {
+      if (burst[i] != '\n') {
+        continue;
+      }
+      // Zdarzenie '\n' obsłużone, gdy zadanie odbiorcze jest wolne; do tej
+      // chwili w buforze przybywa bajtów za zdaniem (kolejka zaległości)
+      if (busyUntilUs < 0) {
+        busyUntilUs = byteUs[i] + c.handlerDelayUs;
+      }
+      int64_t handledUs = byteUs[i] > busyUntilUs ? byteUs[i] : busyUntilUs;
+      size_t bytesAfter = 0;
+      while (i + 1 + bytesAfter < burst.size() && byteUs[i + 1 + bytesAfter] <= handledUs) {
+        bytesAfter++;
+      }
+      NmeaSentence sentence;
+      sentence.len = (uint8_t)(i + 1 - begin);
+      framer.frame(sentence, handledUs, bytesAfter, (uint32_t)charUs);
+      bool valid = parser.encode(burst.data() + begin, sentence.len);
+      begin = i + 1;
+      if (!valid || timeSet || !parser.time.isUpdated() || !parser.date.isValid()) {
+        continue;
+      }
+      time_t second = (time_t)(daysFromCivil(parser.date.year(), parser.date.month(), parser.date.day()) * 86400 +
+                               parser.time.hour() * 3600L + parser.time.minute() * 60L + parser.time.second());
+      uint32_t fractionUs = parser.time.centisecond() * 10000UL;
+      nowUs = handledUs + 2000;   // parsowanie i kolejka zdań
+      tv = gpsBurstToTimeval(second, fractionUs, sentence.burstStartUs, ppsUs, nowUs);
+      timeSet = true;
+    }
+    if (!timeSet) {
+      wrong++;
+      continue;
+    }
+
+    // Prawdziwy czas w chwili nowUs i błąd ustawionego
+    int64_t trueUs = (int64_t)utc * 1000000 + (nowUs - edgeUs);
+    int64_t error = (int64_t)tv.tv_sec * 1000000 + tv.tv_usec - trueUs;
+    synced++;
+    sumError += error;
+    minError = error < minError ? error : minError;
+    maxError = error > maxError ? error : maxError;
+    if (error < c.expectedErrorUs - c.toleranceUs || error > c.expectedErrorUs + c.toleranceUs) {
+      wrong++;
+    }
+  }
+
+  bool ok = wrong == 0 && synced == seconds;
+  printf("[test] %-34s %4d s  błąd [us] śr %+8.1f  min %+7lld  max %+7lld  oczek. %+7lld +- %lld  %s\n",
+         c.name, synced, synced ? (double)sumError / synced : 0.0, (long long)minError, (long long)maxError,
+         (long long)c.expectedErrorUs, (long long)c.toleranceUs, ok ? "ok" : "BŁĄD");
+  return ok;
+}
+
+int hostTestGpsTime() {
+  const int64_t model = GPS_RECEIVER_LATENCY_US;
+  const GpsTimeCase cases[] = {
+    {"model opóźnienia, 9600 bod", 9600, model, 3000, PPS_NONE, 0, 3000, 0},
+    {"model opóźnienia, 115200 bod", 115200, model, 3000, PPS_NONE, 0, 3000, 0},
+    // Ostatni bajt w buforze mógł dojść do znaku przed obsługą: + czas znaku
+    {"zaległe zdarzenia 40 ms, 9600 bod", 9600, model, 3000, PPS_NONE, 0, 3000 + 1042, 40000},
+    {"zaległe zdarzenia 5 ms, 115200 bod", 115200, model, 3000, PPS_NONE, 0, 3000 + 87, 5000},
+    {"odbiornik wolniejszy o 75 ms", 9600, model + 75000, 0, PPS_NONE, -75000, 0, 0},
+    {"PPS, 9600 bod", 9600, 120000, 20000, PPS_EDGE, -3, 0, 0},
+    {"PPS, 115200 bod", 115200, 30000, 20000, PPS_EDGE, -3, 0, 0},
+    {"PPS sprzed 2 s (pominięte)", 9600, model, 0, PPS_STALE, 0, 0, 0},
+    {"PPS w trakcie paczki (pominięte)", 9600, model, 0, PPS_LATE, 0, 0, 0},
+  };
+  const time_t start = 1798761300;   // 2026-12-31 23:55:00 UTC: północ i nowy rok w przebiegu
+  bool ok = true;
+  for (const GpsTimeCase &c : cases) {
+    ok &= replayGpsTime(c, start, 600);
+  }
+  return ok ? 0 : 1;
+}
+
+struct NmeaCase {
+  const char *body;       // zdanie bez '$' i sumy; suma zawsze poprawna
+  bool time;              // czas ma zostać przyjęty
+  bool date;              // data j.w.
+};
+
+int hostTestNmea() {
+  const NmeaCase cases[] = {
+    {"GNRMC,235960.00,A,5213.0000,N,02100.0000,E,0.0,0.0,311216,,,A", true, true},  // sekunda przestępna
+    {"GNRMC,120000.00,A,5213.0000,N,02100.0000,E,0.0,0.0,290224,,,A", true, true},
+    {"GNRMC,256199.00,A,5213.0000,N,02100.0000,E,0.0,0.0,010626,,,A", false, true},
+    {"GNRMC,240000.00,V,,,,,,,010626,,,N", false, true},
+    {"GNRMC,126000.00,V,,,,,,,010626,,,N", false, true},
+    {"GNRMC,120061.00,V,,,,,,,010626,,,N", false, true},
+    {"GNRMC,1200a0.00,V,,,,,,,010626,,,N", false, true},
+    {"GNRMC,120000.00,V,,,,,,,011326,,,N", true, false},
+    {"GNRMC,120000.00,V,,,,,,,001026,,,N", true, false},
+    {"GNRMC,120000.00,V,,,,,,,450626,,,N", true, false},
+    {"GNRMC,120000.00,V,,,,,,,310426,,,N", true, false},
+    {"GNRMC,120000.00,V,,,,,,,290225,,,N", true, false},
+    {"GNGGA,250000.00,,,,,0,00,99.9,,M,,M,,", false, false},
+    {"GNZDA,120000.00,29,02,2100,00,00", true, false},
+    {"GNZDA,120000.00,29,02,2000,00,00", true, true},
+    {"GNZDA,120000.00,15,13,2026,00,00", true, false},
+    {"GNZDA,120000.00,32,01,2026,00,00", true, false},
+    {"GNZDA,120000.00,00,01,2026,00,00", true, false},
+  };
+  int wrong = 0;
+  for (const NmeaCase &c : cases) {
+    std::string line = nmeaSentence(c.body);
+    NmeaParser parser;
+    bool valid = parser.encode(line.data(), line.size());
+    bool time = parser.time.isUpdated();
+    bool date = parser.date.isUpdated();
+    bool ok = valid && time == c.time && date == c.date;
+    if (!ok) {
+      wrong++;
+    }
+    printf("[test] %-66s czas %-3s data %-3s %s\n", c.body, time ? "tak" : "nie", date ? "tak" : "nie",
+           ok ? "ok" : "BŁĄD");
+  }
+
+  // Fiks z RMC i GGA tej samej sekundy liczy się raz
+  NmeaParser parser;
+  for (time_t t = 1780308000; t < 1780308010; t++) {
+    std::string burst = hostNmeaBurst(t);
+    size_t begin = 0;
+    for (size_t end = burst.find('\n'); end != std::string::npos; end = burst.find('\n', begin)) {
+      parser.encode(burst.data() + begin, end + 1 - begin);
+      begin = end + 1;
+    }
+  }
+  bool fixOk = parser.secondsWithFix() == 10;
+  if (!fixOk) {
+    wrong++;
+  }
+  printf("[test] sekundy z fiksem (RMC+GGA): %u z 10  %s\n", (unsigned)parser.secondsWithFix(),
+         fixOk ? "ok" : "BŁĄD");
+  return wrong == 0 ? 0 : 1;
+}
+
+// Licznik sterowany przez test
+static int64_t fakeCounterUs = 0;
+
+static int64_t fakeCounter() {
+  return fakeCounterUs;
+}
+
+// Zegar po przesunięciu licznika o gapUs; false przy różnicy
+static bool checkGap(const char *name, int64_t gapUs, int64_t expectedUs) {
+  fakeCounterUs += gapUs;
+  int64_t micros = nowMicros();
+  time_t seconds = now();
+  bool ok = micros == expectedUs && seconds == (time_t)(expectedUs / 1000000);
+  printf("[test] %-28s %+lld us  %s\n", name, (long long)(micros - expectedUs), ok ? "ok" : "BŁĄD");
+  return ok;
+}
+
+// Cała korekta stopniowa już zastosowana
+static bool checkSlewDone() {
+  int64_t remaining = slewRemaining();
+  printf("[test] %-28s %+lld us  %s\n", "reszta korekty", (long long)remaining, remaining == 0 ? "ok" : "BŁĄD");
+  return remaining == 0;
+}
+
+int hostTestTime() {
+  // Przerwy bez wywołań: stan zegara po kilku dniach liczony bez pętli
+  const int64_t start = 1780308000LL * 1000000 + 250000;  // 2026-06-01 10:00:00.25 UTC
+  const int64_t day = 86400LL * 1000000;
+  setMicrosCounter(fakeCounter);
+  setTimeMicros(start);
+  int64_t expected = start;
+  bool ok = true;
+  ok &= checkGap("ułamek sekundy", 750000, expected += 750000);
+  ok &= checkGap("przerwa 1 h", 3600LL * 1000000, expected += 3600LL * 1000000);
+  ok &= checkGap("przerwa 3 dni", 3 * day + 123, expected += 3 * day + 123);
+  ok &= checkGap("przerwa 50 dni (> millis)", 50 * day, expected += 50 * day);
+  ok &= checkGap("przerwa 400 dni", 400 * day, expected += 400 * day);
+
+  adjustTimeMicros(-1500);
+  ok &= checkGap("krok -1500 us", 0, expected -= 1500);
+
+  // 100 ms przy 500 ppm: połowa po 100 s, całość po 200 s, potem bez zmian
+  slewTime(100000);
+  ok &= checkGap("korekta 100 ms po 100 s", 100LL * 1000000, expected += 100LL * 1000000 + 50000);
+  ok &= checkGap("korekta 100 ms po 200 s", 100LL * 1000000, expected += 100LL * 1000000 + 50000);
+  ok &= checkGap("po korekcie, przerwa 10 dni", 10 * day, expected += 10 * day);
+  ok &= checkSlewDone();
+  slewTime(-20000);
+  ok &= checkGap("korekta -20 ms po 30 s", 30LL * 1000000, expected += 30LL * 1000000 - 15000);
+  ok &= checkGap("korekta -20 ms po 3 dniach", 3 * day, expected += 3 * day - 5000);
+  ok &= checkSlewDone();
+
+  setMicrosCounter(0);
+  return ok ? 0 : 1;
+}
+
+// Pola breakTime() i powrót przez makeTime() dla chwili t; false przy różnicy
+static bool checkTimeLib(time_t t) {
+  struct tm expected;
+  gmtime_r(&t, &expected);
+  tmElements_t fields;
+  breakTime(t, fields);
+  bool ok = tmYearToCalendar(fields.Year) == expected.tm_year + 1900 && fields.Month == expected.tm_mon + 1 &&
+            fields.Day == expected.tm_mday && fields.Hour == expected.tm_hour &&
+            fields.Minute == expected.tm_min && fields.Second == expected.tm_sec &&
+            fields.Wday == expected.tm_wday + 1 && makeTime(fields) == t;
+  if (!ok) {
+    printf("[test] %lld: breakTime %04d-%02d-%02d %02d:%02d:%02d dzień %d, makeTime %lld\n", (long long)t,
+           tmYearToCalendar(fields.Year), fields.Month, fields.Day, fields.Hour, fields.Minute, fields.Second,
+           fields.Wday, (long long)makeTime(fields));
+  }
+  return ok;
+}
+
+int hostTestTimeLib(int passes) {
+  if (sizeof(time_t) < 8) {
+    printf("[test] time_t ma 32 bity - zakres 1970-2225 niedostępny\n");
+    return 1;
+  }
+  const time_t first = 0;                     // 1970-01-01
+  const time_t last = 8078572799LL;           // 2225-12-31 23:59:59
+  const int32_t dayPoints[] = {0, 1, 59, 60, 3599, 3600, 43200, 86340, 86399};
+  std::mt19937 random(2225);
+  std::uniform_int_distribution<int32_t> secondOfDay(0, 86399);
+
+  // Każdy dzień: granice minut, godzin i doby oraz losowa sekunda
+  uint64_t checks = 0;
+  uint64_t failures = 0;
+  for (time_t day = first; day <= last; day += 86400) {
+    for (int32_t s : dayPoints) {
+      failures += !checkTimeLib(day + s);
+    }
+    failures += !checkTimeLib(day + secondOfDay(random));
+    checks += sizeof(dayPoints) / sizeof(dayPoints[0]) + 1;
+    if (failures > 20) {
+      break;
+    }
+  }
+  // Każda sekunda dni przy przestępnych i skrajnych datach
+  const time_t fullDays[] = {first, 951782400 /* 2000-02-29 */, 4107456000LL /* 2100-02-28 */,
+                             4107542400LL /* 2100-03-01 */, 4102358400LL /* 2099-12-31 */, last - 86399};
+  for (time_t day : fullDays) {
+    for (int32_t s = 0; s < 86400 && failures <= 20; s++) {
+      failures += !checkTimeLib(day + s);
+      checks++;
+    }
+  }
+  bool ok = failures == 0;
+  printf("[test] breakTime/makeTime wobec gmtime, 1970-2225: %llu chwil, niezgodnych %llu  %s\n",
+         (unsigned long long)checks, (unsigned long long)failures, ok ? "ok" : "BŁĄD");
+
+  benchTimeLib(passes);
+  return ok ? 0 : 1;
+}
+
+// Przesunięcie czasu lokalnego w chwili utc według zoneinfo
+static int32_t zoneinfoOffset(time_t utc) {
+  struct tm local;
+  localtime_r(&utc, &local);
+  return (int32_t)local.tm_gmtoff;
+}
+
+int hostTestTimezone(const char *zone) {
+  setenv("TZ", zone, 1);
+  tzset();
+  time_t first = (time_t)daysFromCivil(TZ_FIRST_YEAR, 1, 1) * 86400;
+  time_t end = (time_t)daysFromCivil(TZ_LAST_YEAR + 1, 1, 1) * 86400;
+  if (zoneinfoOffset(first) != TZ_STD_OFFSET || zoneinfoOffset(first + 183 * 86400) != TZ_DST_OFFSET) {
+    printf("[test] brak strefy %s w zoneinfo albo inne przesunięcia niż TZ_STD/DST_OFFSET\n", zone);
+    return 2;
+  }
+
+  // Zmiany według zoneinfo: co godzinę, potem bisekcja do sekundy
+  std::vector<time_t> expected;
+  int32_t previous = zoneinfoOffset(first);
+  for (time_t t = first + 3600; t < end; t += 3600) {
+    int32_t offset = zoneinfoOffset(t);
+    if (offset == previous) {
+      continue;
+    }
+    time_t lo = t - 3600;
+    time_t hi = t;
+    while (hi - lo > 1) {
+      time_t mid = lo + (hi - lo) / 2;
+      (zoneinfoOffset(mid) == previous ? lo : hi) = mid;
+    }
+    expected.push_back(hi);
+    previous = offset;
+  }
+
+  // Każda zmiana z zoneinfo: tabela, tzNextTransition() i tzOffset() wokół niej
+  int failures = 0;
+  bool sameCount = (int)expected.size() == Timezone::size;
+  time_t from = first;
+  for (size_t i = 0; i < expected.size(); i++) {
+    time_t t = expected[i];
+    bool ok = i < (size_t)Timezone::size && Timezone::transitions[i].utc == t &&
+              tzNextTransition(from) == t && tzNextTransition(t - 1) == t;
+    for (time_t probe : {t - 3600, t - 1, t, t + 1, t + 3600}) {
+      ok &= tzOffset(probe) == zoneinfoOffset(probe);
+    }
+    if (!ok) {
+      struct tm utc;
+      gmtime_r(&t, &utc);
+      printf("[test] zmiana %04d-%02d-%02d %02d:%02d:%02d UTC: tabela %lld, tzNextTransition %lld\n",
+             utc.tm_year + 1900, utc.tm_mon + 1, utc.tm_mday, utc.tm_hour, utc.tm_min, utc.tm_sec,
+             i < (size_t)Timezone::size ? (long long)Timezone::transitions[i].utc : -1LL,
+             (long long)tzNextTransition(from));
+      failures++;
+    }
+    from = t;
+  }
+  // Poza zmianami: przesunięcie co godzinę przez cały zakres
+  int hourly = 0;
+  for (time_t t = first; t < end; t += 3600) {
+    hourly += tzOffset(t) != zoneinfoOffset(t);
+  }
+  bool ok = sameCount && failures == 0 && hourly == 0;
+  printf("[test] zmiany czasu %d-%d wobec zoneinfo %s: %zu zmian (tabela %d), niezgodnych %d, "
+         "godzin z innym przesunięciem %d  %s\n",
+         TZ_FIRST_YEAR, TZ_LAST_YEAR, zone, expected.size(), Timezone::size, failures, hourly, ok ? "ok" : "BŁĄD");
+  return ok ? 0 : 1;
+}
@@ -0,0 +1,21 @@
+#pragma once
+
+// NVS (Preferences) w pamięci procesu - przetrwa ESP.restart(), nie restart programu
+
+#include <map>
+#include <string>
+
+#include <Arduino.h>
+
+class Preferences {
+public:
+  bool begin(const char *name, bool readOnly = false);
+  void end() {}
+
+  size_t putFloat(const char *key, float value);
+  float getFloat(const char *key, float defaultValue = NAN);
+  bool isKey(const char *key);
+
+private:
+  std::string space;
+};
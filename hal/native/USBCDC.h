@@ -0,0 +1,20 @@
+#pragma once
+
+// Zdarzenia USB CDC (Arduino-ESP32) na hoście - Serial w HostSerial
+
+#include <stdint.h>
+
+typedef const char *esp_event_base_t;
+typedef void (*esp_event_handler_t)(void *arg, esp_event_base_t base, int32_t id, void *data);
+
+typedef enum {
+  ARDUINO_USB_CDC_ANY_EVENT = -1,
+  ARDUINO_USB_CDC_CONNECTED_EVENT = 0,
+  ARDUINO_USB_CDC_DISCONNECTED_EVENT,
+  ARDUINO_USB_CDC_LINE_STATE_EVENT,
+  ARDUINO_USB_CDC_LINE_CODING_EVENT,
+  ARDUINO_USB_CDC_RX_EVENT,
+  ARDUINO_USB_CDC_TX_EVENT,
+  ARDUINO_USB_CDC_RX_OVERFLOW_EVENT,
+  ARDUINO_USB_CDC_MAX_EVENT,
+} arduino_usb_cdc_event_t;
@@ -0,0 +1,23 @@
+#pragma once
+
+// WiFi hosta: sieć systemu, dostępna tylko w czasie rzeczywistym. W symulacji
+// (czas wirtualny) brak połączenia - blokujące gniazdo zatrzymałoby czas.
+
+#include <Arduino.h>
+#include "Hal.h"
+
+enum wifi_mode_t { WIFI_OFF, WIFI_STA, WIFI_AP, WIFI_AP_STA };
+enum wl_status_t { WL_IDLE_STATUS = 0, WL_CONNECTED = 3, WL_DISCONNECTED = 6 };
+
+class WiFiClass {
+public:
+  bool mode(wifi_mode_t m) { (void)m; return true; }
+  bool setSleep(bool enabled) { (void)enabled; return true; }
+  wl_status_t begin(const char *ssid, const char *password) {
+    (void)ssid;
+    (void)password;
+    return status();
+  }
+  wl_status_t status() { return halSimActive() ? WL_DISCONNECTED : WL_CONNECTED; }
+};
+extern WiFiClass WiFi;
@@ -0,0 +1,26 @@
+#pragma once
+
+// Magistrala I2C hosta - transmisje są zliczane, a bajty trafiają do
+// modelu wyświetlacza za PCF8574 (HalLcd)
+
+#include <Arduino.h>
+
+class TwoWire {
+public:
+  bool begin(int sda, int scl, uint32_t frequency = 0);
+  bool setClock(uint32_t frequency);
+  void beginTransmission(uint8_t address);
+  size_t write(uint8_t data);
+  size_t write(const uint8_t *data, size_t size);
+  uint8_t endTransmission(bool sendStop = true);
+
+  uint32_t getClock() const { return frequency; }
+  uint32_t transmissions() const { return txCount; }
+  uint32_t bytesWritten() const { return txBytes; }
+
+private:
+  uint32_t frequency = 100000;
+  uint32_t txCount = 0;
+  uint32_t txBytes = 0;
+};
+extern TwoWire Wire;
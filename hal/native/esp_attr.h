@@ -0,0 +1,5 @@
+#pragma once
+
+// Pamięć RTC na hoście: zwykłe zmienne, które przetrwają ESP.restart()
+#define RTC_NOINIT_ATTR
+#define RTC_DATA_ATTR
@@ -0,0 +1,12 @@
+#pragma once
+
+// Haki FreeRTOS ESP-IDF; host nie ma przerwania ticku, więc hak nie jest wywoływany
+
+#include "esp_err.h"
+
+typedef void (*esp_freertos_tick_cb_t)(void);
+
+inline esp_err_t esp_register_freertos_tick_hook(esp_freertos_tick_cb_t cb) {
+  (void)cb;
+  return ESP_OK;
+}
@@ -0,0 +1,9 @@
+#pragma once
+
+#include <stdint.h>
+#include "esp_err.h"
+#include "driver/uart.h"
+
+esp_err_t esp_sleep_enable_timer_wakeup(uint64_t timeUs);
+esp_err_t esp_sleep_enable_uart_wakeup(int port);
+esp_err_t esp_light_sleep_start();
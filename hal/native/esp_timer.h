@@ -0,0 +1,6 @@
+#pragma once
+
+#include <stdint.h>
+
+// Czas monotoniczny hosta w mikrosekundach od startu
+int64_t esp_timer_get_time();
@@ -0,0 +1,38 @@
+#pragma once
+
+// Podzbiór FreeRTOS na wątkach hosta
+
+#include <stdint.h>
+#include <mutex>
+
+typedef uint32_t TickType_t;
+typedef int BaseType_t;
+typedef unsigned int UBaseType_t;
+
+#define pdTRUE 1
+#define pdFALSE 0
+#define pdPASS pdTRUE
+#define pdFAIL pdFALSE
+#define portMAX_DELAY ((TickType_t)0xffffffffUL)
+#define configTICK_RATE_HZ 1000
+#define configMAX_PRIORITIES 25
+#define tskNO_AFFINITY 0x7fffffff
+#define pdMS_TO_TICKS(ms) ((TickType_t)(ms))
+#define portTICK_PERIOD_MS 1
+
+// Sekcja krytyczna - na hoście zwykły mutex
+struct portMUX_TYPE {
+  std::mutex lock;
+};
+#define portMUX_INITIALIZER_UNLOCKED {}
+#define portENTER_CRITICAL(mux) (mux)->lock.lock()
+#define portEXIT_CRITICAL(mux) (mux)->lock.unlock()
+#define portENTER_CRITICAL_ISR(mux) portENTER_CRITICAL(mux)
+#define portEXIT_CRITICAL_ISR(mux) portEXIT_CRITICAL(mux)
+#define portYIELD_FROM_ISR(woken) (void)(woken)
+
+struct HalQueue;
+struct HalTask;
+typedef HalQueue *QueueHandle_t;
+typedef HalTask *TaskHandle_t;
+typedef void (*TaskFunction_t)(void *);
@@ -0,0 +1,8 @@
+#pragma once
+
+// Gniazda lwIP na hoście - API BSD systemu
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
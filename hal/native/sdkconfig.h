@@ -0,0 +1,3 @@
+#pragma once
+
+// Brak opcji IDF na hoście (m.in. CONFIG_PM_ENABLE)
@@ -0,0 +1,26 @@
+#pragma once
+
+#include <Arduino.h>
+
+// Migawka stanu odbiornika publikowana przez zadanie GNSS po każdej paczce
+// zdań (Seqlock). Czytelnicy (zegar, ekran, kontrola stanu) nie sięgają do
+// parsera, więc nie blokują go ani nie widzą pół-sparsowanego zdania.
+struct GnssFix {
+  // Czas UTC ze zdania, które przyniosło świeży czas i datę
+  uint16_t year;
+  uint8_t month;
+  uint8_t day;
+  uint8_t hour;
+  uint8_t minute;
+  uint8_t second;
+  uint8_t centisecond;
+  int64_t burstStartUs;     // początek paczki z tym czasem (esp_timer)
+  uint32_t timeSequence;    // zwiększany przy każdym świeżym czasie z datą
+
+  bool satellitesValid;
+  uint8_t satellites;
+  bool locationValid;
+
+  uint32_t passedChecksum;
+  uint32_t failedChecksum;
+};
@@ -0,0 +1,73 @@
+#pragma once
+
+#include <Arduino.h>
+#include "GpsUart.h"
+
+// Prędkość łącza odbiornika po włączeniu zasilania
+#ifndef GPS_DEFAULT_BAUD
+#define GPS_DEFAULT_BAUD 9600
+#endif
+
+// Docelowa prędkość łącza (PCAS01); GPS_DEFAULT_BAUD - bez zmiany
+#ifndef GPS_CONFIG_BAUD
+#define GPS_CONFIG_BAUD 115200
+#endif
+
+// Okres wyznaczania pozycji [ms] (PCAS02): 1000, 500, 250, 200 lub 100
+#ifndef GPS_FIX_INTERVAL_MS
+#define GPS_FIX_INTERVAL_MS 1000
+#endif
+
+// Czas nasłuchu przy jednej prędkości podczas wykrywania
+#ifndef GPS_CONFIG_DETECT_MS
+#define GPS_CONFIG_DETECT_MS 1500
+#endif
+
+// Brak poprawnych zdań przez ten czas - odbiornik wykrywany od nowa
+// (np. po zaniku zasilania wrócił do GPS_DEFAULT_BAUD)
+#ifndef GPS_CONFIG_LOST_MS
+#define GPS_CONFIG_LOST_MS 5000
+#endif
+
+// Stan konfiguracji odbiornika
+enum GpsConfigStatus : uint8_t {
+  CONFIG_IDLE,        // konfiguracja nie rozpoczęta
+  CONFIG_DETECTING,   // szukamy prędkości, przy której przychodzą poprawne zdania
+  CONFIG_VERIFYING,   // wysłano PCAS01, sprawdzamy odbiór przy nowej prędkości
+  CONFIG_DONE,        // odbiornik skonfigurowany
+  CONFIG_FALLBACK     // nowa prędkość nie działa - zostajemy przy wykrytej
+};
+
+// Konfiguracja odbiornika AT6558R poleceniami PCAS: tylko RMC i GGA,
+// wyższa prędkość łącza i opcjonalnie częstszy fiks. Ustawienia nie są
+// zapisywane we flash odbiornika, więc po zaniku zasilania wraca on do
+// ustawień fabrycznych i konfiguracja powtarza się sama.
+class GpsConfig {
+public:
+  explicit GpsConfig(GpsUart &uart) : uart(uart) {}
+
+  // Rozpoczyna wykrywanie prędkości od GPS_DEFAULT_BAUD
+  void start();
+
+  // Krok po każdym odebranym zdaniu; valid - poprawna suma kontrolna
+  // (po zmianie prędkości przychodzą śmieci)
+  void step(const NmeaSentence &sentence, bool valid);
+
+  // Limity czasu wykrywania i weryfikacji
+  void poll();
+
+  GpsConfigStatus status() const { return state; }
+  bool busy() const { return state == CONFIG_DETECTING || state == CONFIG_VERIFYING; }
+
+private:
+  void listen(uint32_t baud);
+  void configure();
+  void send(const char *body);
+
+  GpsUart &uart;
+  GpsConfigStatus state = CONFIG_IDLE;
+  uint32_t detectedBaud = 0;
+  uint32_t stateTime = 0;      // millis() wejścia w stan / zmiany prędkości
+  uint32_t lastValidTime = 0;  // millis() ostatniego poprawnego zdania
+  int64_t listenUs = 0;        // zdania zakończone wcześniej są ze starej prędkości
+};
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <Arduino.h>
+#include "GnssFix.h"
+
+// Stan synchronizacji zegara z GPS
+enum GpsSyncStatus : uint8_t {
+  SYNC_IDLE,        // brak synchronizacji w toku
+  SYNC_WAITING,     // czekamy na poprawny czas z GPS
+  SYNC_OK,          // ostatnia synchronizacja udana
+  SYNC_FAILED       // ostatnia synchronizacja przekroczyła limit czasu
+};
+
+// Jakość czasu ustawionego z GPS
+enum GpsSyncTier : uint8_t {
+  TIER_NONE,          // zegar nie był ustawiony z GPS
+  TIER_PROVISIONAL,   // czas z kolejnych sekund bez fiksa pozycji
+  TIER_FIX            // czas potwierdzony fiksem pozycji
+};
+
+// Czas tymczasowy: dwie kolejne sekundy, których paczki przyszły
+// w odstępie 1 s z tą tolerancją
+#ifndef SYNC_PROVISIONAL_TOLERANCE_US
+#define SYNC_PROVISIONAL_TOLERANCE_US 200000
+#endif
+
+// Zapis czasu z GPS do zegara systemowego
+typedef void (*GpsSyncCommit)(const GnssFix &fix, GpsSyncTier tier);
+
+// Nieblokująca synchronizacja: krok po każdej migawce z zadania GNSS
+class GpsSync {
+public:
+  explicit GpsSync(GpsSyncCommit commit) : commit(commit) {}
+
+  // Rozpoczyna synchronizację. timeoutMs == 0 - bez limitu czasu,
+  // minSatellites > 0 - wymagany fiks pozycji z co najmniej tyloma satelitami,
+  // provisional - przed fiksem zegar dostaje czas tymczasowy, a synchronizacja
+  // czeka dalej na fiks
+  void start(uint32_t timeoutMs, uint8_t minSatellites, bool provisional);
+
+  // Krok po nowej migawce; zapisuje czas, gdy przyszedł świeży (po start())
+  void step(const GnssFix &fix);
+
+  // Sprawdza limit czasu
+  void poll();
+
+  GpsSyncStatus status() const { return state; }
+  GpsSyncTier tier() const { return quality; }
+  bool busy() const { return state == SYNC_WAITING; }
+
+private:
+  GpsSyncCommit commit;
+  volatile GpsSyncStatus state = SYNC_IDLE;   // czytany przez zadanie ekranu
+  volatile GpsSyncTier quality = TIER_NONE;
+  uint32_t lastTimeSequence = 0;
+  int64_t lastSecond = -1;                    // poprzedni świeży czas (UTC)
+  int64_t lastBurstUs = 0;
+  bool allowProvisional = false;
+  uint32_t startTime = 0;
+  uint32_t timeout = 0;
+  uint8_t minSats = 0;
+};
@@ -0,0 +1,41 @@
+#pragma once
+
+#include <Arduino.h>
+#include <sys/time.h>
+
+// Opóźnienie odbiornika: od pełnej sekundy UTC do pierwszego bajtu paczki
+// zdań raportujących tę sekundę (AT6558R @ 1 Hz; skalibrować względem PPS)
+#ifndef GPS_RECEIVER_LATENCY_US
+#define GPS_RECEIVER_LATENCY_US 45000
+#endif
+
+// Wejście PPS odbiornika; -1 gdy nie podłączone
+#ifndef PPS_PIN
+#define PPS_PIN -1
+#endif
+
+// Niepewność samego ustawienia zegara z GPS [us]: model opóźnienia paczki
+// NMEA bez PPS, ułamek z PPS (błąd ogłaszany przez NTP i łącze USB)
+#ifndef GPS_SYNC_ERROR_US
+#define GPS_SYNC_ERROR_US (PPS_PIN >= 0 ? 50 : 2000)
+#endif
+
+// Czas systemowy odpowiadający chwili nowUs, jeśli sekunda `second`
+// (plus `fractionUs`) rozpoczęła się w chwili refUs - latencyUs
+struct timeval gpsTimeToTimeval(time_t second, uint32_t fractionUs,
+                                int64_t refUs, int64_t latencyUs, int64_t nowUs);
+
+// Jak wyżej dla paczki zdań, której pierwszy bajt odebrano w chwili
+// burstStartUs: od zbocza PPS ppsUs, jeśli należy do tej paczki (w ciągu
+// sekundy przed nią; 0 - brak PPS), inaczej z GPS_RECEIVER_LATENCY_US
+struct timeval gpsBurstToTimeval(time_t second, uint32_t fractionUs, int64_t burstStartUs,
+                                 int64_t ppsUs, int64_t nowUs);
+
+// Włącza przerwanie PPS (gdy PPS_PIN >= 0)
+void gpsTimeBegin();
+
+// Koryguje zegar systemowy sekundą zgłoszoną w paczce zdań, której pierwszy
+// bajt odebrano w chwili burstStartUs (Holdover). Używa zbocza PPS, jeśli
+// należy do tej paczki, inaczej modelu opóźnienia. provisional - czas bez
+// fiksa pozycji (Holdover nie mierzy na nim dryftu).
+void gpsSetTime(time_t second, uint32_t fractionUs, int64_t burstStartUs, bool provisional);
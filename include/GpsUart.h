@@ -0,0 +1,108 @@
+#pragma once
+
+#include <Arduino.h>
+#include <driver/uart.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/queue.h>
+#include <freertos/task.h>
+
+// Maksymalna długość zdania NMEA (standard: 82 znaki razem z CR LF)
+#ifndef GPS_SENTENCE_MAX
+#define GPS_SENTENCE_MAX 96
+#endif
+
+// Liczba zdań, które mogą czekać na parser
+#ifndef GPS_SENTENCE_QUEUE_LEN
+#define GPS_SENTENCE_QUEUE_LEN 16
+#endif
+
+// Przerwa w odbiorze oddzielająca paczki zdań kolejnych sekund
+#ifndef GPS_BURST_GAP_US
+#define GPS_BURST_GAP_US 100000
+#endif
+
+// Kompletne zdanie NMEA odebrane z UART
+struct NmeaSentence {
+  char data[GPS_SENTENCE_MAX + 1];
+  uint8_t len;
+  int64_t startUs;      // szacowany czas odebrania pierwszego bajtu zdania
+  int64_t burstStartUs; // j.w. dla pierwszego zdania bieżącej paczki
+  int64_t endUs;        // szacowany czas odebrania '\n' (GpsBurstFramer)
+};
+
+// Liczniki odbioru
+struct GpsUartStats {
+  uint32_t bytes;            // bajty odebrane (razem z utraconymi)
+  uint32_t sentences;        // zdania przekazane do parsera
+  uint32_t droppedBytes;     // bajty utracone (przepełnienie FIFO/bufora/kolejki)
+  uint32_t overflowEvents;   // zdarzenia przepełnienia sterownika UART
+  uint32_t lastLatencyUs;    // koniec zdania -> sparsowane (ostatnie)
+  uint32_t maxLatencyUs;     // j.w. (maksimum)
+  uint64_t sumLatencyUs;     // j.w. (suma, do średniej)
+};
+
+// Czasy zdań i podział na paczki sekund. Sterownik nie podaje chwili
+// odebrania '\n', a zdarzenie może czekać w kolejce za innymi. Dlatego koniec
+// zdania liczymy wstecz od chwili obsługi o bajty odebrane już po nim:
+// przy ciągłym nadawaniu dotarły później, po jednym co czas znaku.
+// Zostaje opóźnienie obsługi po ucichnięciu łącza oraz bajty, które
+// czekają jeszcze w FIFO sprzętowym (do następnego '\n' lub przekroczenia
+// czasu RX); koniec nie wypada też wcześniej, niż pozwala poprzednie zdanie.
+struct GpsBurstFramer {
+  int64_t lastEndUs = 0;
+  int64_t burstStartUs = 0;
+
+  // Uzupełnia startUs, burstStartUs i endUs zdania o sentence.len bajtach
+  void frame(NmeaSentence &sentence, int64_t handledUs, size_t bytesAfter, uint32_t charTimeUs);
+};
+
+// Odbiór NMEA sterowany przerwaniami: sterownik UART ESP-IDF wykrywa '\n'
+// (pattern detection), zadanie odbiorcze kopiuje całe zdania do kolejki.
+class GpsUart {
+public:
+  explicit GpsUart(uart_port_t port) : port(port) {}
+
+  bool begin(uint32_t baud, int rxPin, int txPin);
+
+  // Zmienia prędkość łącza; bajty odebrane przy starej prędkości są odrzucane
+  void setBaud(uint32_t baud);
+  uint32_t baud() const { return currentBaud; }
+
+  // Wysyła dane do odbiornika (polecenia konfiguracyjne)
+  void write(const char *data, size_t len);
+
+  // Pobiera kolejne zdanie; czeka najwyżej `wait` ticków
+  bool read(NmeaSentence &sentence, TickType_t wait = 0);
+
+  // Wywoływane po sparsowaniu zdania - mierzy opóźnienie
+  void parsed(const NmeaSentence &sentence);
+
+  GpsUartStats stats() const;
+
+  // Brak danych w buforze i przerwa po ostatnim zdaniu dłuższa niż GPS_BURST_GAP_US
+  bool idle(int64_t nowUs) const;
+
+  // Początek ostatniej paczki zdań (esp_timer_get_time), 0 przed pierwszą
+  int64_t lastBurstStartUs() const;
+
+  uart_port_t uartPort() const { return port; }
+
+  // Zadanie odbiorcze (kontrola zapasu stosu)
+  TaskHandle_t taskHandle() const { return task; }
+
+private:
+  static void eventTask(void *arg);
+  void handleEvents();
+  void readSentence();
+  void dropInput();
+
+  uart_port_t port;
+  uint32_t currentBaud = 0;
+  uint32_t charTimeUs = 0;      // czas transmisji jednego znaku (10 bitów)
+  GpsBurstFramer framer;        // pod statsMux
+  QueueHandle_t eventQueue = nullptr;
+  QueueHandle_t sentenceQueue = nullptr;
+  TaskHandle_t task = nullptr;
+  GpsUartStats counters = {};
+  mutable portMUX_TYPE statsMux = portMUX_INITIALIZER_UNLOCKED;
+};
@@ -0,0 +1,59 @@
+#pragma once
+
+#include <Arduino.h>
+
+// Wyświetlacz HD44780 w trybie 4-bitowym przez ekspander PCF8574 (I2C).
+// Ciąg półbajtów z impulsami EN dla całego fragmentu tekstu pakowany jest
+// w jeden bufor Wire: jedna transmisja (START/STOP) na wiersz zamiast
+// kilku na każdy półbajt.
+
+// Bufor transmisji Wire (I2C_BUFFER_LENGTH w Arduino-ESP32)
+#ifndef HD44780_I2C_BUFFER
+#define HD44780_I2C_BUFFER 128
+#endif
+
+// Liczniki magistrali I2C
+struct LcdBusStats {
+  uint32_t transactions;   // transmisje I2C
+  uint32_t bytes;          // bajty do PCF8574 (bez adresu)
+  uint32_t busUs;          // szacowany czas magistrali [us]
+};
+
+class Hd44780 : public Print {
+public:
+  Hd44780(uint8_t address, uint8_t cols, uint8_t rows);
+
+  // Sekwencja startowa HD44780 (Wire musi być już uruchomiony)
+  void init();
+  void clear();
+  void setCursor(uint8_t col, uint8_t row);
+  void backlight();
+  void noBacklight();
+
+  // Wzór znaku CGRAM 0-7 (8 wierszy po 5 bitów)
+  void createChar(uint8_t location, const uint8_t charmap[8]);
+
+  size_t write(uint8_t c) override;
+  size_t write(const uint8_t *data, size_t size) override;
+  using Print::write;
+
+  // Ustawienie kursora i znaki w jednej transmisji
+  void writeAt(uint8_t col, uint8_t row, const char *text, uint8_t length);
+
+  LcdBusStats stats() const { return counters; }
+
+private:
+  void command(uint8_t value);
+  void pushByte(uint8_t value, bool data);
+  void pushNibble(uint8_t nibble, bool data);
+  void sendBatch();
+  uint8_t cursorCommand(uint8_t col, uint8_t row) const;
+
+  uint8_t address;
+  uint8_t cols;
+  uint8_t rows;
+  uint8_t backlightBit;
+  uint8_t batch[HD44780_I2C_BUFFER];
+  uint8_t batchLength = 0;
+  LcdBusStats counters = {};
+};
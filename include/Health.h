@@ -0,0 +1,78 @@
+#pragma once
+
+#include <Arduino.h>
+#include "GnssFix.h"
+#include "GpsUart.h"
+
+// Kontrola stanu w czasie pracy: sterta, stosy zadań, odbiór GPS.
+// Restart tylko po przekroczeniu progu (zamiast codziennego o 05:00).
+
+// Najmniejsza wolna sterta [B]
+#ifndef HEALTH_MIN_FREE_HEAP
+#define HEALTH_MIN_FREE_HEAP 16384
+#endif
+
+// Najmniejszy największy wolny blok sterty (fragmentacja) [B]
+#ifndef HEALTH_MIN_LARGEST_BLOCK
+#define HEALTH_MIN_LARGEST_BLOCK 4096
+#endif
+
+// Najmniejszy zapas stosu zadania (high-water mark) [B]
+#ifndef HEALTH_MIN_STACK
+#define HEALTH_MIN_STACK 256
+#endif
+
+// Bajty z odbiornika napływają, a żadne zdanie nie przechodzi sumy
+// kontrolnej przez tyle czasu - odbiór zablokowany
+#ifndef HEALTH_GPS_STALL_MS
+#define HEALTH_GPS_STALL_MS 300000UL
+#endif
+
+// Najwięcej obserwowanych zadań
+#ifndef HEALTH_MAX_TASKS
+#define HEALTH_MAX_TASKS 8
+#endif
+
+enum HealthFault : uint8_t {
+  HEALTH_OK,
+  HEALTH_HEAP,            // mało wolnej sterty
+  HEALTH_FRAGMENTATION,   // brak dużego wolnego bloku
+  HEALTH_STACK,           // zadanie blisko przepełnienia stosu
+  HEALTH_GPS_STALLED,     // odbiór NMEA stoi mimo danych na UART
+  HEALTH_FAULTS
+};
+
+struct HealthTaskStack {
+  const char *name;
+  uint32_t freeBytes;        // zapas stosu (high-water mark) [B]
+};
+
+struct HealthStats {
+  uint32_t freeHeap;
+  uint32_t minFreeHeap;      // najniższy stan od startu
+  uint32_t largestBlock;
+  uint8_t tasks;
+  HealthTaskStack stacks[HEALTH_MAX_TASKS];
+  uint32_t uartOverflows;
+  uint32_t checksumPassed;
+  uint32_t checksumFailed;
+  uint32_t sinceValidMs;     // od ostatniego poprawnego zdania
+  uint8_t resetReason;       // esp_reset_reason_t
+  HealthFault lastFault;     // powód poprzedniego restartu z kontroli stanu
+};
+
+void healthBegin();
+
+// Dodaje zadanie do kontroli zapasu stosu
+void healthWatchTask(TaskHandle_t task);
+
+// Wywoływane w pętli (pomiar raz na sekundę). Zwraca przekroczony próg;
+// po HEALTH_OK nic nie trzeba robić, inaczej wywołujący restartuje.
+HealthFault healthCheck(const GpsUartStats &uart, const GnssFix &fix);
+
+// Zapisuje powód przed restartem, żeby trafił do raportu po starcie
+void healthRecordRestart(HealthFault fault);
+
+const char *healthFaultName(HealthFault fault);
+
+HealthStats healthStats();
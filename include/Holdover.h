@@ -0,0 +1,80 @@
+#pragma once
+
+#include <Arduino.h>
+#include <sys/time.h>
+
+// Prowadzenie zegara systemowego między synchronizacjami GPS: pomiar dryftu
+// kwarcu (ppm) względem esp_timer, korekta częstotliwości przez adjtime()
+// i interwał synchronizacji dobierany do zmierzonej stabilności.
+
+// Większe przesunięcie ustawiane skokiem (settimeofday), mniejsze płynnie
+#ifndef HOLDOVER_STEP_US
+#define HOLDOVER_STEP_US 100000
+#endif
+
+// Dopuszczalny szacowany błąd zegara przed kolejną synchronizacją
+#ifndef HOLDOVER_MAX_ERROR_US
+#define HOLDOVER_MAX_ERROR_US 20000
+#endif
+
+// Granice interwału synchronizacji
+#ifndef HOLDOVER_MIN_INTERVAL_MS
+#define HOLDOVER_MIN_INTERVAL_MS 600000UL
+#endif
+#ifndef HOLDOVER_MAX_INTERVAL_MS
+#define HOLDOVER_MAX_INTERVAL_MS 86400000UL
+#endif
+
+// Interwał, dopóki dryft nie jest zmierzony
+#ifndef HOLDOVER_INITIAL_INTERVAL_MS
+#define HOLDOVER_INITIAL_INTERVAL_MS 3600000UL
+#endif
+
+// Najkrótszy odcinek między synchronizacjami użyty do pomiaru dryftu
+#ifndef HOLDOVER_MIN_BASELINE_MS
+#define HOLDOVER_MIN_BASELINE_MS 600000UL
+#endif
+
+// Niepewność częstotliwości przed pierwszym pomiarem (tolerancja kwarcu)
+#ifndef HOLDOVER_INITIAL_PPM_ERROR
+#define HOLDOVER_INITIAL_PPM_ERROR 20.0f
+#endif
+
+struct HoldoverStats {
+  float ppm;                  // dryft kwarcu (+ - esp_timer się spóźnia)
+  float ppmError;             // niepewność dryftu
+  bool ppmValid;
+  int32_t lastOffsetUs;       // GPS - zegar przy ostatniej synchronizacji
+  uint32_t syncs;
+  uint32_t steps;             // synchronizacje zakończone skokiem
+  uint32_t intervalMs;        // bieżący interwał synchronizacji
+  uint32_t sinceSyncMs;
+  uint32_t estimatedErrorUs;  // szacowany błąd zegara w tej chwili
+};
+
+// Stan do zachowania między restartami (WarmStart)
+struct HoldoverState {
+  float ppm;
+  float ppmError;
+  bool ppmValid;
+  uint32_t intervalMs;
+};
+
+// Czas z GPS `gps`, ważny w chwili nowUs (esp_timer): pierwszy raz
+// i przy dużym przesunięciu skok, inaczej płynna korekta. Czas tymczasowy
+// (provisional, bez fiksa) ustawia zegar, ale nie zaczyna pomiaru dryftu.
+void holdoverSync(const struct timeval &gps, int64_t nowUs, bool provisional);
+
+// Wywoływane w pętli; doprowadza korektę częstotliwości do adjtime()
+void holdoverTick();
+
+// Czas do następnej synchronizacji wynikający ze zmierzonej stabilności
+uint32_t holdoverInterval();
+
+HoldoverStats holdoverStats();
+
+HoldoverState holdoverState();
+
+// Przywraca dryft po restarcie; clockValid - zegar systemowy przetrwał
+// restart, więc następna synchronizacja tylko go potwierdza (bez skoku)
+void holdoverResume(const HoldoverState &state, bool clockValid);
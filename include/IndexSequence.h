@@ -0,0 +1,7 @@
+#pragma once
+
+// Sekwencja indeksów 0..N-1 (C++11 nie ma std::make_index_sequence) do tabel
+// liczonych w czasie kompilacji: MakeIndices<N>::type to Indices<0, ..., N-1>
+template <int... I> struct Indices {};
+template <int N, int... I> struct MakeIndices : MakeIndices<N - 1, N - 1, I...> {};
+template <int... I> struct MakeIndices<0, I...> { typedef Indices<I...> type; };
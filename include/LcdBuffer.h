@@ -0,0 +1,61 @@
+#pragma once
+
+#include <Arduino.h>
+#include "Hd44780.h"
+
+// Liczniki transferu do wyświetlacza
+struct LcdStats {
+  uint32_t flushes;     // wywołania flush()
+  uint32_t chars;       // wysłane znaki
+  uint32_t commands;    // wysłane komendy setCursor
+  LcdBusStats bus;      // magistrala I2C (łącznie z init i createChar)
+  uint32_t lastBusUs;   // czas magistrali ostatniego flush() ze zmianami [us]
+  uint32_t maxBusUs;    // najdłuższy flush() [us]
+  uint32_t sumBusUs;    // suma czasu magistrali wszystkich flush() [us]
+};
+
+// Bufor ekranu 2x16 w pamięci. Aplikacja rysuje do bufora, a flush()
+// wysyła do LCD tylko zmienione fragmenty wierszy.
+class LcdBuffer : public Print {
+public:
+  static const uint8_t COLS = 16;
+  static const uint8_t ROWS = 2;
+
+  explicit LcdBuffer(Hd44780 &lcd) : lcd(lcd) { clear(); }
+
+  void setCursor(uint8_t col, uint8_t row);
+  size_t write(uint8_t c) override;
+  using Print::write;
+
+  // Czyści bufor (same spacje); na LCD trafi przy flush()
+  void clear();
+
+  // Wiersz do bezpośredniego wpisywania pól. Stały tekst szablonu layout
+  // (COLS znaków) kopiowany jest tylko, gdy wiersz zawiera coś innego.
+  char *row(uint8_t row, const char *layout);
+
+  // Zawartość LCD nieznana (np. po lcd.clear()) - następny flush() wyśle wszystko
+  void invalidate();
+
+  // Wysyła różnice między buforem a zawartością LCD
+  void flush();
+
+  // Zawartość wiersza w buforze (COLS znaków, bez '\0')
+  const char *text(uint8_t row) const { return cells[row]; }
+
+  LcdStats stats() const;
+
+private:
+  void sendRun(uint8_t row, uint8_t from, uint8_t to);
+
+  Hd44780 &lcd;
+  char cells[ROWS][COLS];
+  char shown[ROWS][COLS];
+  const char *layouts[ROWS] = {};   // szablon obecny w wierszu; nullptr - inna treść
+  uint8_t cursorCol = 0;
+  uint8_t cursorRow = 0;
+  int8_t lcdCol = -1;      // pozycja kursora LCD; -1 gdy nieznana
+  int8_t lcdRow = -1;
+  bool shownValid = false;
+  LcdStats counters = {};
+};
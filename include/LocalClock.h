@@ -0,0 +1,40 @@
+#pragma once
+
+#include <Arduino.h>
+#include <time.h>
+
+// Rozłożony czas lokalny aktualizowany przyrostowo: kolejne sekundy
+// przenoszone są na minuty, godziny i dni bez ponownej konwersji.
+// Pełne przeliczenie tylko po invalidate() (resync), skoku czasu
+// lub zmianie czasu letni/zimowy.
+class LocalClock {
+public:
+  // Przesuwa pola do chwili utc
+  void update(time_t utc);
+
+  // Zegar systemowy został przestawiony - następny update() przelicza od zera
+  void invalidate() { valid = false; }
+
+  const struct tm &fields() const { return tm; }
+  int hour() const { return tm.tm_hour; }
+  int minute() const { return tm.tm_min; }
+  int second() const { return tm.tm_sec; }
+  int day() const { return tm.tm_mday; }
+  int month() const { return tm.tm_mon + 1; }
+  int year() const { return tm.tm_year + 1900; }
+  int weekday() const { return tm.tm_wday; }     // 0 = niedziela
+
+  // Liczba pełnych przeliczeń (diagnostyka)
+  uint32_t fullConversions() const { return conversions; }
+
+private:
+  void convert(time_t utc);
+  void advanceSecond();
+  void advanceDay();
+
+  struct tm tm = {};
+  time_t current = 0;          // UTC
+  time_t nextTransition = 0;   // najbliższa zmiana czasu (UTC), 0 - brak
+  bool valid = false;
+  uint32_t conversions = 0;
+};
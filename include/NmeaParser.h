@@ -0,0 +1,120 @@
+#pragma once
+
+#include <Arduino.h>
+
+// Największa liczba pól w obsługiwanych zdaniach (RMC ma 13, GGA 14)
+#ifndef NMEA_MAX_FIELDS
+#define NMEA_MAX_FIELDS 20
+#endif
+
+// Wartość z zdania NMEA - interfejs jak w TinyGPS++: isValid() po pierwszym
+// zapisie, isUpdated() do najbliższego odczytu value()
+class NmeaValue {
+public:
+  bool isValid() const { return valid; }
+  bool isUpdated() const { return updated; }
+  uint32_t age() const { return valid ? millis() - commitTime : (uint32_t)-1; }
+
+protected:
+  void commit() {
+    valid = updated = true;
+    commitTime = millis();
+  }
+
+  bool valid = false;
+  bool updated = false;
+  uint32_t commitTime = 0;
+
+  friend class NmeaParser;
+};
+
+// Czas UTC (hhmmsscc)
+class NmeaTime : public NmeaValue {
+public:
+  uint32_t value() { updated = false; return raw; }
+  uint8_t hour() { updated = false; return raw / 1000000; }
+  uint8_t minute() { updated = false; return raw / 10000 % 100; }
+  uint8_t second() { updated = false; return raw / 100 % 100; }
+  uint8_t centisecond() { updated = false; return raw % 100; }
+
+private:
+  uint32_t raw = 0;
+  friend class NmeaParser;
+};
+
+// Data (ddmmrr; rok pełny)
+class NmeaDate : public NmeaValue {
+public:
+  uint32_t value() { updated = false; return (uint32_t)d * 10000 + m * 100 + y % 100; }
+  uint16_t year() { updated = false; return y; }
+  uint8_t month() { updated = false; return m; }
+  uint8_t day() { updated = false; return d; }
+
+private:
+  uint16_t y = 0;
+  uint8_t m = 0;
+  uint8_t d = 0;
+  friend class NmeaParser;
+};
+
+// Liczba satelitów użytych do fiksa (GGA)
+class NmeaSatellites : public NmeaValue {
+public:
+  uint32_t value() { updated = false; return count; }
+
+private:
+  uint8_t count = 0;
+  friend class NmeaParser;
+};
+
+// Pozycja: zapamiętany tekst pól, stopnie liczone dopiero przy odczycie
+class NmeaLocation : public NmeaValue {
+public:
+  double lat();
+  double lng();
+
+private:
+  char rawLat[16] = "";   // ddmm.mmmm + półkula
+  char rawLng[16] = "";   // dddmm.mmmm + półkula
+  friend class NmeaParser;
+};
+
+// Parser RMC/GGA/ZDA działający na całym zdaniu naraz (bez kopiowania pól).
+// Suma kontrolna i przecinki szukane są po 4 bajty; czas, data, liczba
+// satelitów i status fiksa trafiają od razu do liczb całkowitych.
+class NmeaParser {
+public:
+  // Zdanie od '$' (CR LF opcjonalne); true - poprawna suma kontrolna
+  bool encode(const char *data, size_t len);
+
+  NmeaTime time;
+  NmeaDate date;
+  NmeaSatellites satellites;
+  NmeaLocation location;
+
+  uint32_t charsProcessed() const { return chars; }
+  uint32_t passedChecksum() const { return passed; }
+  uint32_t failedChecksum() const { return failed; }
+  // Sekundy z fiksem (RMC i GGA z tym samym czasem liczą się raz)
+  uint32_t secondsWithFix() const { return withFix; }
+
+private:
+  void parseRmc();
+  void parseGga();
+  void parseZda();
+
+  // Pole i (0 - nagłówek) bieżącego zdania
+  const char *field(uint8_t i) const { return sentence + starts[i]; }
+  uint8_t fieldLen(uint8_t i) const { return starts[i + 1] - starts[i] - 1; }
+  bool setTime(uint8_t i);
+  void setLocation(uint8_t latField);
+
+  const char *sentence = nullptr;
+  uint8_t fields = 0;
+  uint8_t starts[NMEA_MAX_FIELDS + 1];
+  uint32_t chars = 0;
+  uint32_t passed = 0;
+  uint32_t failed = 0;
+  uint32_t withFix = 0;
+  uint32_t fixTime = UINT32_MAX;   // time.raw ostatnio policzonego fiksa
+};
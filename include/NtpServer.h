@@ -0,0 +1,59 @@
+#pragma once
+
+#include <Arduino.h>
+#include "GpsSync.h"
+#include "GpsTime.h"
+#include "Holdover.h"
+#include "Power.h"
+
+// Serwer SNTP (NTPv4, RFC 4330) w sieci WiFi: zegar ustawiany z GPS jako
+// źródło stratum 1 dla urządzeń w sieci lokalnej. Odpowiedź powstaje
+// z gotowego szablonu pakietu (bez alokacji), znaczniki czasu odbioru
+// i nadania brane tuż przy wywołaniach gniazda.
+
+#ifndef NTP_SERVER_ENABLE
+#define NTP_SERVER_ENABLE 0
+#endif
+
+// Sieć WiFi (build_flags)
+#ifndef NTP_WIFI_SSID
+#define NTP_WIFI_SSID ""
+#endif
+#ifndef NTP_WIFI_PASSWORD
+#define NTP_WIFI_PASSWORD ""
+#endif
+
+#ifndef NTP_PORT
+#define NTP_PORT 123
+#endif
+
+// Szacowany błąd, powyżej którego serwer zgłasza brak synchronizacji [us]
+#ifndef NTP_MAX_ERROR_US
+#define NTP_MAX_ERROR_US 100000UL
+#endif
+
+#if NTP_SERVER_ENABLE && LOW_POWER_MODE
+#error "Light sleep gubi pakiety WiFi - NTP_SERVER_ENABLE wymaga LOW_POWER_MODE 0"
+#endif
+
+struct NtpServerStats {
+  bool connected;          // WiFi połączone, gniazdo otwarte
+  uint32_t requests;       // odebrane datagramy
+  uint32_t replies;
+  uint32_t ignored;        // za krótkie lub nie od klienta (mode != 3)
+  uint32_t lastServiceUs;  // od znacznika odbioru do nadania
+  uint32_t maxServiceUs;
+  uint64_t sumServiceUs;
+  uint8_t stratum;         // ogłaszany w tej chwili
+};
+
+// Łączy z WiFi i uruchamia zadanie serwera (NTP_SERVER_ENABLE)
+void ntpServerBegin();
+
+// Nowy stan zegara do szablonu odpowiedzi (zadanie zegara, co sekundę)
+void ntpServerUpdate(GpsSyncTier tier, const HoldoverStats &holdover);
+
+TaskHandle_t ntpServerTask();
+
+// Spójna migawka liczników (Seqlock, pisze tylko zadanie ntp)
+NtpServerStats ntpServerStats();
@@ -0,0 +1,35 @@
+#pragma once
+
+#include <Arduino.h>
+#include "GpsUart.h"
+
+// Tryb niskiego poboru: CPU 80 MHz i light sleep między sekundami.
+// USB CDC (Serial) na ESP32-S2 nie działa w czasie snu.
+#ifndef LOW_POWER_MODE
+#define LOW_POWER_MODE 0
+#endif
+
+// Częstotliwość CPU w trybie niskiego poboru
+#ifndef LOW_POWER_CPU_MHZ
+#define LOW_POWER_CPU_MHZ 80
+#endif
+
+// Statystyka czasu pracy od powerBegin()
+struct PowerStats {
+  uint64_t totalUs;     // czas od startu pomiaru
+  uint64_t idleUs;      // CPU bezczynny (próbkowanie w ticku FreeRTOS, w tym sen)
+  uint64_t sleepUs;     // light sleep
+  uint32_t sleeps;      // liczba wejść w light sleep
+  uint32_t cpuMhz;
+};
+
+void powerBegin();
+
+// Przerwa zadania o najniższym priorytecie (loop), gdy pozostałe czekają.
+// W trybie niskiego poboru, przy ustawionym zegarze, po paczce NMEA bieżącej
+// sekundy i bezczynnym UART light sleep do chwili tuż przed pełną sekundą;
+// potem budzi zadanie
+// `wake` (ticki FreeRTOS stoją w czasie snu). Inaczej czeka 20 ms.
+void powerIdle(GpsUart &uart, bool clockValid, TaskHandle_t wake);
+
+PowerStats powerStats();
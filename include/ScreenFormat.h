@@ -0,0 +1,83 @@
+#pragma once
+
+#include <Arduino.h>
+#include "IndexSequence.h"
+
+// Formatowanie pól ekranu bez strftime/Print: cyfry z tabeli par liczonej
+// w czasie kompilacji, stały tekst wiersza w szablonie. Do bufora wiersza
+// trafiają tylko zmienne znaki.
+
+// Znak i tabeli par: "000102...99"
+constexpr char fmtDigitPairChar(int i) {
+  return (char)('0' + (i % 2 == 0 ? i / 2 / 10 : i / 2 % 10));
+}
+
+template <class Sequence> struct FmtDigitTable;
+template <int... I> struct FmtDigitTable<Indices<I...>> {
+  static constexpr char pairs[sizeof...(I)] = {fmtDigitPairChar(I)...};
+};
+template <int... I>
+constexpr char FmtDigitTable<Indices<I...>>::pairs[sizeof...(I)];
+
+typedef FmtDigitTable<MakeIndices<200>::type> FmtDigits;
+
+static_assert(FmtDigits::pairs[0] == '0' && FmtDigits::pairs[15] == '7' && FmtDigits::pairs[198] == '9',
+              "tabela par cyfr");
+
+// Dwie cyfry z zerem wiodącym (0-99)
+inline void fmt2(char *dst, uint8_t value) {
+  dst[0] = FmtDigits::pairs[value * 2];
+  dst[1] = FmtDigits::pairs[value * 2 + 1];
+}
+
+// Cztery cyfry (0-9999)
+inline void fmt4(char *dst, uint16_t value) {
+  fmt2(dst, (uint8_t)(value / 100));
+  fmt2(dst + 2, (uint8_t)(value % 100));
+}
+
+// Szablon wiersza 16 znaków; pole - pozycja, na której szablon ma spacje
+constexpr bool fmtBlank(const char *text, int pos, int len) {
+  return len == 0 || (text[pos] == ' ' && fmtBlank(text, pos + 1, len - 1));
+}
+
+// Wiersz czasu: "12:34:56* SAT:08"
+struct TimeRow {
+  static constexpr const char *text = "  :  :    SAT:  ";
+  static const uint8_t HOUR = 0;
+  static const uint8_t MINUTE = 3;
+  static const uint8_t SECOND = 6;
+  static const uint8_t STATUS = 8;
+  static const uint8_t SATELLITES = 14;
+};
+static_assert(fmtBlank(TimeRow::text, TimeRow::HOUR, 2) && fmtBlank(TimeRow::text, TimeRow::MINUTE, 2) &&
+              fmtBlank(TimeRow::text, TimeRow::SECOND, 2) && fmtBlank(TimeRow::text, TimeRow::STATUS, 1) &&
+              fmtBlank(TimeRow::text, TimeRow::SATELLITES, 2) && TimeRow::text[16] == '\0',
+              "pola wiersza czasu");
+
+// Wiersz daty: " Pon, 01.06.2026"
+struct DateRow {
+  static constexpr const char *text = "    ,   .  .    ";
+  static const uint8_t WEEKDAY = 1;
+  static const uint8_t DAY = 6;
+  static const uint8_t MONTH = 9;
+  static const uint8_t YEAR = 12;
+};
+static_assert(fmtBlank(DateRow::text, DateRow::WEEKDAY, 3) && fmtBlank(DateRow::text, DateRow::DAY, 2) &&
+              fmtBlank(DateRow::text, DateRow::MONTH, 2) && fmtBlank(DateRow::text, DateRow::YEAR, 4) &&
+              DateRow::text[16] == '\0',
+              "pola wiersza daty");
+
+// Ekran oczekiwania: "Czekam na GPS.. " / "Sat: 8  Fix: NIE"
+struct WaitRow0 {
+  static constexpr const char *text = "Czekam na GPS.  ";
+  static const uint8_t DOTS = 14;
+};
+struct WaitRow1 {
+  static constexpr const char *text = "Sat:    Fix:    ";
+  static const uint8_t SATELLITES = 5;
+  static const uint8_t FIX = 13;
+};
+static_assert(fmtBlank(WaitRow0::text, WaitRow0::DOTS, 2) && fmtBlank(WaitRow1::text, WaitRow1::SATELLITES, 2) &&
+              fmtBlank(WaitRow1::text, WaitRow1::FIX, 3) && WaitRow1::text[16] == '\0',
+              "pola ekranu oczekiwania");
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <atomic>
+#include <stdint.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+
+// Publikacja migawki przez jednego pisarza. Pisarz nigdy nie czeka, czytelnik
+// powtarza kopiowanie, jeśli w jego trakcie trwał zapis (licznik nieparzysty
+// albo zmieniony). T - zwykła struktura kopiowana przez przypisanie.
+// Warunek: czytelnik ma priorytet nie wyższy niż pisarz. Na jednym rdzeniu
+// (ESP32-S2) czytelnik wyższego priorytetu, który wywłaszczył pisarza w trakcie
+// zapisu, kręciłby się bez końca - dlatego przy zapisie w toku oddaje tick.
+template <typename T>
+class Seqlock {
+public:
+  void write(const T &value) {
+    uint32_t seq = sequence.load(std::memory_order_relaxed);
+    sequence.store(seq + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    data = value;
+    sequence.store(seq + 2, std::memory_order_release);
+  }
+
+  // Zwraca numer wersji (rośnie z każdym zapisem)
+  uint32_t read(T &value) const {
+    while (true) {
+      uint32_t before = sequence.load(std::memory_order_acquire);
+      if (before & 1) {
+        vTaskDelay(1);   // zapis w toku - pisarz musi dostać CPU, by go skończyć
+        continue;
+      }
+      value = data;
+      std::atomic_thread_fence(std::memory_order_acquire);
+      if (sequence.load(std::memory_order_relaxed) == before) {
+        return before / 2;
+      }
+    }
+  }
+
+private:
+  std::atomic<uint32_t> sequence{0};
+  T data = {};
+};
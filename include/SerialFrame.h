@@ -0,0 +1,42 @@
+#pragma once
+
+#include <Arduino.h>
+
+// Ramki binarne na Serial (USB) przeplatane z tekstem raportu:
+// A5 5A | typ | długość (u16 LE) | dane | Fletcher-16 (u16 LE) z typu, długości i danych.
+// Cała ramka idzie jednym Serial.write() - zapis USB CDC jest niepodzielny,
+// więc ramki z różnych zadań się nie przeplatają.
+
+enum SerialFrameType : uint8_t {
+  FRAME_TRACE_EVENTS = 1,       // Trace: zdarzenia
+  FRAME_TRACE_HISTOGRAMS = 2,   // Trace: histogramy
+  FRAME_TIME_POLL = 3,          // TimeLink: zapytanie hosta
+  FRAME_TIME_REPLY = 4          // TimeLink: odpowiedź z czasem
+};
+
+// Najdłuższe dane ramki wysyłanej i odbieranej
+#define SERIAL_FRAME_MAX_PAYLOAD 384
+#define SERIAL_FRAME_MAX_RX 32
+
+void serialFrameSend(uint8_t type, const uint8_t *payload, uint16_t len);
+
+// Składa ramki z kolejnych bajtów; tekst i błędne ramki są pomijane
+class SerialFrameReader {
+public:
+  // true, gdy bajt zakończył poprawną ramkę
+  bool push(uint8_t byte);
+
+  uint8_t type() const { return header[0]; }
+  uint16_t length() const { return len; }
+  const uint8_t *payload() const { return data; }
+  uint32_t errors() const { return bad; }
+
+private:
+  uint8_t state = 0;
+  uint8_t header[3];
+  uint16_t len = 0;
+  uint16_t pos = 0;
+  uint8_t data[SERIAL_FRAME_MAX_RX];
+  uint8_t trailer[2];
+  uint32_t bad = 0;
+};
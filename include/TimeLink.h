@@ -0,0 +1,50 @@
+#pragma once
+
+#include <Arduino.h>
+#include "GnssFix.h"
+#include "GpsSync.h"
+#include "Holdover.h"
+
+// Czas po USB (Serial) dla hosta bez anteny GNSS: host wysyła ramkę
+// FRAME_TIME_POLL (SerialFrame.h), urządzenie odpowiada FRAME_TIME_REPLY
+// z chwilą odbioru zapytania, chwilą nadania i słowem jakości.
+// Klient hosta i źródło dla chrony (refclock SOCK): tools/timelink_client.py
+
+#ifndef TIME_LINK_ENABLE
+#define TIME_LINK_ENABLE 1
+#endif
+
+// Zapytanie (12 B, LE): numer u32, znacznik hosta u64 - odsyłane bez zmian.
+// Odpowiedź (40 B, LE):
+//   numer u32, znacznik hosta u64,
+//   odbiór UTC: s u32, us u32, nadanie UTC: s u32, us u32,
+//   flagi u8, satelity u8, 0 u16, od synchronizacji [ms] u32, szacowany błąd [us] u32
+static const uint8_t TIME_LINK_POLL_SIZE = 12;
+static const uint8_t TIME_LINK_REPLY_SIZE = 40;
+
+enum TimeLinkFlags : uint8_t {
+  TIME_LINK_CLOCK_SET = 1 << 0,     // zegar ustawiony z GPS lub wznowiony po restarcie
+  TIME_LINK_FIX = 1 << 1,           // czas potwierdzony fiksem pozycji
+  TIME_LINK_PROVISIONAL = 1 << 2,   // czas tymczasowy (bez fiksa)
+  TIME_LINK_SYNC_FAILED = 1 << 3    // ostatnia resynchronizacja nieudana
+};
+
+struct TimeLinkStats {
+  uint32_t polls;          // poprawne ramki zapytania
+  uint32_t badFrames;      // błędna suma lub długość
+  uint32_t lastServiceUs;  // od znacznika odbioru do nadania
+  uint32_t maxServiceUs;
+  uint64_t sumServiceUs;
+};
+
+// Uruchamia zadanie obsługi zapytań (TIME_LINK_ENABLE)
+void timeLinkBegin();
+
+// Nowy stan zegara do słowa jakości (zadanie zegara, co sekundę)
+void timeLinkUpdate(bool clockSet, GpsSyncTier tier, GpsSyncStatus status, const GnssFix &fix,
+                    const HoldoverStats &holdover);
+
+TaskHandle_t timeLinkTask();
+
+// Spójna migawka liczników (Seqlock, pisze tylko zadanie timeLink)
+TimeLinkStats timeLinkStats();
@@ -0,0 +1,69 @@
+#pragma once
+
+#include <Arduino.h>
+#include <TimeLib.h>
+#include "IndexSequence.h"
+
+// Strefa czasowa z tabelą zmian czasu liczoną w czasie kompilacji.
+// Reguła UE: czas letni od ostatniej niedzieli marca 01:00 UTC
+// do ostatniej niedzieli października 01:00 UTC.
+
+// Domyślnie Europe/Warsaw (CET/CEST)
+#ifndef TZ_STD_OFFSET
+#define TZ_STD_OFFSET 3600
+#endif
+#ifndef TZ_DST_OFFSET
+#define TZ_DST_OFFSET 7200
+#endif
+
+// Zakres lat objętych tabelą
+#ifndef TZ_FIRST_YEAR
+#define TZ_FIRST_YEAR 2000
+#endif
+#ifndef TZ_LAST_YEAR
+#define TZ_LAST_YEAR 2100
+#endif
+
+struct TzTransition {
+  int64_t utc;        // chwila zmiany (UTC)
+  int32_t offset;     // przesunięcie obowiązujące od tej chwili [s]
+};
+
+// Dzień (od 1970-01-01) ostatniej niedzieli miesiąca
+constexpr int64_t tzLastSundayFromDay(int64_t lastDay) {
+  return lastDay - (int64_t)(weekdayFromDays(lastDay) - 1);
+}
+constexpr int64_t tzLastSunday(int64_t year, unsigned month) {
+  return tzLastSundayFromDay(daysFromCivil(year, month, 31));  // marzec i październik mają 31 dni
+}
+
+// i-ta zmiana w tabeli: parzyste - początek czasu letniego, nieparzyste - koniec
+constexpr TzTransition tzTransition(int i) {
+  return TzTransition{tzLastSunday(TZ_FIRST_YEAR + i / 2, i % 2 == 0 ? 3 : 10) * 86400 + 3600,
+                      i % 2 == 0 ? TZ_DST_OFFSET : TZ_STD_OFFSET};
+}
+
+template <class Sequence> struct TzTable;
+template <int... I> struct TzTable<Indices<I...>> {
+  static constexpr int size = sizeof...(I);
+  static constexpr TzTransition transitions[sizeof...(I)] = {tzTransition(I)...};
+};
+template <int... I>
+constexpr TzTransition TzTable<Indices<I...>>::transitions[sizeof...(I)];
+
+typedef TzTable<MakeIndices<(TZ_LAST_YEAR - TZ_FIRST_YEAR + 1) * 2>::type> Timezone;
+
+static_assert(Timezone::transitions[0].utc == 954032400, "2000-03-26 01:00 UTC");
+static_assert(Timezone::transitions[1].utc == 972781200, "2000-10-29 01:00 UTC");
+
+// Przesunięcie czasu lokalnego względem UTC w chwili utc [s]
+int32_t tzOffset(time_t utc);
+
+// Czas lokalny (jako sekundy od epoki) dla chwili utc
+inline time_t tzUtcToLocal(time_t utc) { return utc + tzOffset(utc); }
+
+// Najbliższa zmiana czasu po chwili utc; 0, gdy poza tabelą
+time_t tzNextTransition(time_t utc);
+
+// Czy w chwili utc obowiązuje czas letni
+inline bool tzIsDst(time_t utc) { return tzOffset(utc) != TZ_STD_OFFSET; }
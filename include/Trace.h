@@ -0,0 +1,92 @@
+#pragma once
+
+#include <Arduino.h>
+#include <esp_timer.h>
+
+// Lekki śledzik czasu pętli: zdarzenia ze znacznikiem czasu w pierścieniu
+// bez blokad, histogramy okresu pętli i opóźnienia ekranu względem pełnej
+// sekundy. Zdarzenia mogą płynąć binarnie po Serial (tools/trace_decode.py).
+
+// Rejestracja zdarzeń (0 - wyłączona, wywołania znikają)
+#ifndef TRACE_ENABLE
+#define TRACE_ENABLE 1
+#endif
+
+// Strumień ramek binarnych po Serial (miesza się z raportem tekstowym)
+#ifndef TRACE_STREAM
+#define TRACE_STREAM 0
+#endif
+
+// Pojemność pierścienia (potęga dwójki)
+#ifndef TRACE_RING_SIZE
+#define TRACE_RING_SIZE 128
+#endif
+
+static_assert((TRACE_RING_SIZE & (TRACE_RING_SIZE - 1)) == 0, "TRACE_RING_SIZE musi być potęgą 2");
+
+enum TraceEvent : uint8_t {
+  TRACE_LOOP,         // cała iteracja loop()
+  TRACE_TIME_LCD,     // displayTimeOnLCD()
+  TRACE_DATE_LCD,     // displayDateOnLCD()
+  TRACE_LCD_FLUSH,    // zapis zmian na LCD (I2C); arg - znaki
+  TRACE_BACKLIGHT,    // updateBacklight()
+  TRACE_GPS_WAIT,     // czekanie na zdanie
+  TRACE_GPS_BATCH,    // parsowanie paczki zdań; arg - liczba zdań
+  TRACE_SYNC,         // zapis czasu z GPS
+  TRACE_EVENTS
+};
+
+// Zdarzenie w ramce binarnej (12 B, little endian)
+struct TraceRecord {
+  uint32_t startUs;      // esp_timer (młodsze 32 bity)
+  uint32_t durationUs;
+  uint16_t arg;
+  uint8_t event;
+  uint8_t reserved;
+};
+
+static_assert(sizeof(TraceRecord) == 12, "TraceRecord bez wyrównania");
+
+// Histogram log2: kubełek b obejmuje [2^(b-1), 2^b) us, ostatni - resztę
+#define TRACE_HIST_BUCKETS 20
+
+struct TraceHistogram {
+  uint32_t count[TRACE_HIST_BUCKETS];
+  uint32_t maxUs;
+  uint32_t total;
+
+  void add(uint32_t us);
+  // Górna granica kubełka zawierającego percentyl p (0-100)
+  uint32_t percentile(uint8_t p) const;
+};
+
+struct TraceStats {
+  TraceHistogram loopPeriod;   // odstęp między początkami iteracji loop()
+  TraceHistogram displayLag;   // pełna sekunda -> nowa sekunda na LCD
+  uint32_t events;
+  uint32_t overwritten;        // nadpisane przed wysłaniem (przy strumieniu)
+};
+
+#if TRACE_ENABLE
+
+inline uint32_t traceStart() { return (uint32_t)esp_timer_get_time(); }
+
+// Zapisuje zdarzenie trwające od startUs do teraz; bezpieczne z wielu zadań
+void traceRecord(TraceEvent event, uint32_t startUs, uint16_t arg = 0);
+
+// Opóźnienie wyświetlenia nowej sekundy względem jej początku
+void traceDisplayLag(uint32_t lagUs);
+
+#else
+
+inline uint32_t traceStart() { return 0; }
+inline void traceRecord(TraceEvent, uint32_t, uint16_t = 0) {}
+inline void traceDisplayLag(uint32_t) {}
+
+#endif
+
+// Wywoływane w pętli: przy TRACE_STREAM wysyła zaległe zdarzenia i co
+// minutę histogramy
+void traceExport();
+
+TraceStats traceStats();
@@ -0,0 +1,36 @@
+#pragma once
+
+#include <Arduino.h>
+
+// Szybki start po restarcie programowym z kontroli stanu (Health) lub watchdoga.
+// Zegar systemowy ESP-IDF (RTC) przetrwa restart, a stan zapisywany co
+// sekundę w pamięci RTC mówi, czy był ustawiony i jaki był dryft. Dryft
+// trafia też do NVS, więc przetrwa wyłączenie zasilania.
+
+// Najdłuższa przerwa od ostatniego zapisu, po której zegar uznajemy za ważny
+#ifndef WARM_START_MAX_GAP_S
+#define WARM_START_MAX_GAP_S 600
+#endif
+
+// Etapy startu mierzone od uruchomienia aplikacji (esp_timer)
+enum BootStage : uint8_t {
+  BOOT_SETUP,     // początek setup()
+  BOOT_LCD,       // wyświetlacz gotowy
+  BOOT_CLOCK,     // zegar ważny (wznowiony lub z GPS)
+  BOOT_SCREEN,    // pierwszy poprawny czas na ekranie
+  BOOT_STAGES
+};
+
+// Przy starcie: przywraca dryft i - po restarcie programowym - zegar.
+// true - czas jest ważny od razu, GPS tylko go potwierdzi
+bool warmStartBegin();
+
+// Stan fiksa sprzed restartu (po warmStartBegin)
+bool warmStartHadFix();
+
+// Zapis stanu (najwyżej raz na sekundę)
+void warmStartSave(bool clockValid, uint8_t satellites, bool fix);
+
+// Chwila osiągnięcia etapu (liczy się pierwsza); po BOOT_SCREEN profil
+// startu trafia na Serial
+void bootMark(BootStage stage);
@@ -3,95 +3,134 @@
  *
  * Updated for Arduino 1.5.7 18 July 2014
  *
- * No memory is consumed in the sketch if your code does not call any of the string methods
- * You can change the text of the strings, make sure the short strings are each exactly 3 characters 
- * the long strings can be any length up to the constant dt_MAX_STRING_LEN defined in TimeLib.h
- * 
+ * The strings are returned as pointers straight into constant tables (flash on
+ * ESP32), so nothing is copied and two calls in one expression don't overwrite
+ * each other. The locale is chosen with TIME_LOCALE (see TimeLocale.h).
+ * You can change the text of the strings, make sure the short strings are each exactly 3 characters
  */
 
 #include <Arduino.h>
 
-// Arduino.h should properly define PROGMEM, PGM_P, strcpy_P, pgm_read_byte, pgm_read_ptr
-// But not all platforms define these as they should.  If you find a platform needing these
-// defined, or if any this becomes unnecessary as platforms improve, please send a pull req.
-#if defined(ESP8266)
-#undef PROGMEM
-#define PROGMEM
-#endif
-
 #include "TimeLib.h"
 
- 
-// the short strings for each day or month must be exactly dt_SHORT_STR_LEN
-#define dt_SHORT_STR_LEN  3 // the length of short strings
-
-static char buffer[dt_MAX_STRING_LEN+1];  // must be big enough for longest string and the terminating null
-
-const char monthStr0[] PROGMEM = "";
-const char monthStr1[] PROGMEM = "January";
-const char monthStr2[] PROGMEM = "February";
-const char monthStr3[] PROGMEM = "March";
-const char monthStr4[] PROGMEM = "April";
-const char monthStr5[] PROGMEM = "May";
-const char monthStr6[] PROGMEM = "June";
-const char monthStr7[] PROGMEM = "July";
-const char monthStr8[] PROGMEM = "August";
-const char monthStr9[] PROGMEM = "September";
-const char monthStr10[] PROGMEM = "October";
-const char monthStr11[] PROGMEM = "November";
-const char monthStr12[] PROGMEM = "December";
-
-const PROGMEM char * const PROGMEM monthNames_P[] =
-{
-    monthStr0,monthStr1,monthStr2,monthStr3,monthStr4,monthStr5,monthStr6,
-    monthStr7,monthStr8,monthStr9,monthStr10,monthStr11,monthStr12
+// length of a table entry, rejected at compile time above the locale's maxLength
+template <unsigned length, unsigned maxLength>
+struct TimeTextLength {
+  static_assert(length <= maxLength, "date string longer than the locale's maxLength");
+  static const uint8_t value = length;
 };
 
-const char monthShortNames_P[] PROGMEM = "ErrJanFebMarAprMayJunJulAugSepOctNovDec";
+#define TIME_TEXT(s) {s, TimeTextLength<sizeof(s) - 1, TIME_TEXT_MAX>::value}
 
-const char dayStr0[] PROGMEM = "Err";
-const char dayStr1[] PROGMEM = "Sunday";
-const char dayStr2[] PROGMEM = "Monday";
-const char dayStr3[] PROGMEM = "Tuesday";
-const char dayStr4[] PROGMEM = "Wednesday";
-const char dayStr5[] PROGMEM = "Thursday";
-const char dayStr6[] PROGMEM = "Friday";
-const char dayStr7[] PROGMEM = "Saturday";
+/* English */
 
-const PROGMEM char * const PROGMEM dayNames_P[] =
-{
-   dayStr0,dayStr1,dayStr2,dayStr3,dayStr4,dayStr5,dayStr6,dayStr7
+#define TIME_TEXT_MAX TimeLocaleEn::maxLength
+
+const TimeText TimeLocaleEn::months[13] = {
+  TIME_TEXT(""), TIME_TEXT("January"), TIME_TEXT("February"), TIME_TEXT("March"),
+  TIME_TEXT("April"), TIME_TEXT("May"), TIME_TEXT("June"), TIME_TEXT("July"),
+  TIME_TEXT("August"), TIME_TEXT("September"), TIME_TEXT("October"),
+  TIME_TEXT("November"), TIME_TEXT("December")
+};
+
+const TimeText TimeLocaleEn::monthsShort[13] = {
+  TIME_TEXT("Err"), TIME_TEXT("Jan"), TIME_TEXT("Feb"), TIME_TEXT("Mar"), TIME_TEXT("Apr"),
+  TIME_TEXT("May"), TIME_TEXT("Jun"), TIME_TEXT("Jul"), TIME_TEXT("Aug"), TIME_TEXT("Sep"),
+  TIME_TEXT("Oct"), TIME_TEXT("Nov"), TIME_TEXT("Dec")
+};
+
+const TimeText TimeLocaleEn::days[8] = {
+  TIME_TEXT("Err"), TIME_TEXT("Sunday"), TIME_TEXT("Monday"), TIME_TEXT("Tuesday"),
+  TIME_TEXT("Wednesday"), TIME_TEXT("Thursday"), TIME_TEXT("Friday"), TIME_TEXT("Saturday")
+};
+
+const TimeText TimeLocaleEn::daysShort[8] = {
+  TIME_TEXT("Err"), TIME_TEXT("Sun"), TIME_TEXT("Mon"), TIME_TEXT("Tue"),
+  TIME_TEXT("Wed"), TIME_TEXT("Thu"), TIME_TEXT("Fri"), TIME_TEXT("Sat")
 };
 
-const char dayShortNames_P[] PROGMEM = "ErrSunMonTueWedThuFriSat";
+const TimeGlyph *const TimeLocaleEn::glyphs = 0;
+
+/* Polish: CGRAM codes of the letters (1 and 5 as in the original sketch) */
+
+#undef TIME_TEXT_MAX
+#define TIME_TEXT_MAX TimeLocalePl::maxLength
+
+#define PL_a "\x01"  // ą
+#define PL_l "\x02"  // ł
+#define PL_n "\x03"  // ń
+#define PL_z "\x04"  // ź
+#define PL_S "\x05"  // Ś
+
+const TimeGlyph TimeLocalePl::glyphs[5] = {
+  {PL_a[0], {0x00, 0x0E, 0x01, 0x0F, 0x11, 0x0F, 0x02, 0x01}, "ą"},
+  {PL_l[0], {0x0C, 0x04, 0x06, 0x0C, 0x04, 0x04, 0x0E, 0x00}, "ł"},
+  {PL_n[0], {0x02, 0x04, 0x16, 0x19, 0x11, 0x11, 0x11, 0x00}, "ń"},
+  {PL_z[0], {0x02, 0x04, 0x1F, 0x02, 0x04, 0x08, 0x1F, 0x00}, "ź"},
+  {PL_S[0], {0x02, 0x0F, 0x10, 0x0E, 0x01, 0x01, 0x1E, 0x00}, "Ś"}
+};
+
+const TimeText TimeLocalePl::months[13] = {
+  TIME_TEXT(""), TIME_TEXT("Stycze" PL_n), TIME_TEXT("Luty"), TIME_TEXT("Marzec"),
+  TIME_TEXT("Kwiecie" PL_n), TIME_TEXT("Maj"), TIME_TEXT("Czerwiec"), TIME_TEXT("Lipiec"),
+  TIME_TEXT("Sierpie" PL_n), TIME_TEXT("Wrzesie" PL_n), TIME_TEXT("Pa" PL_z "dziernik"),
+  TIME_TEXT("Listopad"), TIME_TEXT("Grudzie" PL_n)
+};
+
+const TimeText TimeLocalePl::monthsShort[13] = {
+  TIME_TEXT("Err"), TIME_TEXT("Sty"), TIME_TEXT("Lut"), TIME_TEXT("Mar"), TIME_TEXT("Kwi"),
+  TIME_TEXT("Maj"), TIME_TEXT("Cze"), TIME_TEXT("Lip"), TIME_TEXT("Sie"), TIME_TEXT("Wrz"),
+  TIME_TEXT("Pa" PL_z), TIME_TEXT("Lis"), TIME_TEXT("Gru")
+};
+
+const TimeText TimeLocalePl::days[8] = {
+  TIME_TEXT("Err"), TIME_TEXT("Niedziela"), TIME_TEXT("Poniedzia" PL_l "ek"), TIME_TEXT("Wtorek"),
+  TIME_TEXT(PL_S "roda"), TIME_TEXT("Czwartek"), TIME_TEXT("Pi" PL_a "tek"), TIME_TEXT("Sobota")
+};
+
+const TimeText TimeLocalePl::daysShort[8] = {
+  TIME_TEXT("Err"), TIME_TEXT("Nie"), TIME_TEXT("Pon"), TIME_TEXT("Wto"),
+  TIME_TEXT(PL_S "ro"), TIME_TEXT("Czw"), TIME_TEXT("Pi" PL_a), TIME_TEXT("Sob")
+};
 
 /* functions to return date strings */
 
-char* monthStr(uint8_t month)
+TimeText monthText(uint8_t month)
+{
+   return TimeLocale::months[month <= 12 ? month : 0];
+}
+
+TimeText monthShortText(uint8_t month)
+{
+   return TimeLocale::monthsShort[month <= 12 ? month : 0];
+}
+
+TimeText dayText(uint8_t day)
+{
+   return TimeLocale::days[day <= 7 ? day : 0];
+}
+
+TimeText dayShortText(uint8_t day)
+{
+   return TimeLocale::daysShort[day <= 7 ? day : 0];
+}
+
+const char* monthStr(uint8_t month)
 {
-    strcpy_P(buffer, (PGM_P)pgm_read_ptr(&(monthNames_P[month])));
-    return buffer;
+   return monthText(month).text;
 }
 
-char* monthShortStr(uint8_t month)
+const char* monthShortStr(uint8_t month)
 {
-   for (int i=0; i < dt_SHORT_STR_LEN; i++)      
-      buffer[i] = pgm_read_byte(&(monthShortNames_P[i+ (month*dt_SHORT_STR_LEN)]));  
-   buffer[dt_SHORT_STR_LEN] = 0;
-   return buffer;
+   return monthShortText(month).text;
 }
 
-char* dayStr(uint8_t day) 
+const char* dayStr(uint8_t day)
 {
-   strcpy_P(buffer, (PGM_P)pgm_read_ptr(&(dayNames_P[day])));
-   return buffer;
+   return dayText(day).text;
 }
 
-char* dayShortStr(uint8_t day) 
+const char* dayShortStr(uint8_t day)
 {
-   uint8_t index = day*dt_SHORT_STR_LEN;
-   for (int i=0; i < dt_SHORT_STR_LEN; i++)      
-      buffer[i] = pgm_read_byte(&(dayShortNames_P[index + i]));  
-   buffer[dt_SHORT_STR_LEN] = 0; 
-   return buffer;
+   return dayShortText(day).text;
 }
@@ -33,26 +33,35 @@
 #include <WProgram.h> 
 #endif
 
+#include <atomic>
+#include <mutex>
+
 #include "TimeLib.h"
 
-static tmElements_t tm;          // a cache of time elements
-static time_t cacheTime;   // the time the cache was updated
-static uint32_t syncInterval = 300;  // time sync will be attempted after this many seconds
+static std::atomic<uint32_t> syncInterval(300);  // time sync will be attempted after this many seconds
 
-void refreshCache(time_t t) {
-  if (t != cacheTime) {
-    breakTime(t, tm); 
-    cacheTime = t; 
+void TimeFields::set(time_t time) {
+  if (!valid || time != t) {
+    breakTime(time, tm);
+    t = time;
+    valid = true;
   }
 }
 
+// hour(t), minute(t)... break the time down in a cache of the calling task,
+// so tasks never overwrite each other's fields
+static const TimeFields &cachedFields(time_t t) {
+  static thread_local TimeFields cache;
+  cache.set(t);
+  return cache;
+}
+
 int hour() { // the hour now 
   return hour(now()); 
 }
 
 int hour(time_t t) { // the hour for the given time
-  refreshCache(t);
-  return tm.Hour;  
+  return cachedFields(t).hour();
 }
 
 int hourFormat12() { // the hour now in 12 hour format
@@ -60,13 +69,7 @@ int hourFormat12() { // the hour now in 12 hour format
 }
 
 int hourFormat12(time_t t) { // the hour for the given time in 12 hour format
-  refreshCache(t);
-  if( tm.Hour == 0 )
-    return 12; // 12 midnight
-  else if( tm.Hour  > 12)
-    return tm.Hour - 12 ;
-  else
-    return tm.Hour ;
+  return cachedFields(t).hourFormat12();
 }
 
 uint8_t isAM() { // returns true if time now is AM
@@ -90,8 +93,7 @@ int minute() {
 }
 
 int minute(time_t t) { // the minute for the given time
-  refreshCache(t);
-  return tm.Minute;  
+  return cachedFields(t).minute();
 }
 
 int second() {
@@ -99,8 +101,7 @@ int second() {
 }
 
 int second(time_t t) {  // the second for the given time
-  refreshCache(t);
-  return tm.Second;
+  return cachedFields(t).second();
 }
 
 int day(){
@@ -108,8 +109,7 @@ int day(){
 }
 
 int day(time_t t) { // the day for the given time (0-6)
-  refreshCache(t);
-  return tm.Day;
+  return cachedFields(t).day();
 }
 
 int weekday() {   // Sunday is day 1
@@ -117,8 +117,7 @@ int weekday() {   // Sunday is day 1
 }
 
 int weekday(time_t t) {
-  refreshCache(t);
-  return tm.Wday;
+  return cachedFields(t).weekday();
 }
    
 int month(){
@@ -126,8 +125,7 @@ int month(){
 }
 
 int month(time_t t) {  // the month for the given time
-  refreshCache(t);
-  return tm.Month;
+  return cachedFields(t).month();
 }
 
 int year() {  // as in Processing, the full four digit year: (2009, 2010 etc) 
@@ -135,152 +133,241 @@ int year() {  // as in Processing, the full four digit year: (2009, 2010 etc)
 }
 
 int year(time_t t) { // the year for the given time
-  refreshCache(t);
-  return tmYearToCalendar(tm.Year);
+  return cachedFields(t).year();
 }
 
 /*============================================================================*/	
 /* functions to convert to and from system time */
 /* These are for interfacing with time services and are not normally needed in a sketch */
 
-// leap year calculator expects year argument as years offset from 1970
-#define LEAP_YEAR(Y)     ( ((1970+(Y))>0) && !((1970+(Y))%4) && ( ((1970+(Y))%100) || !((1970+(Y))%400) ) )
-
-static  const uint8_t monthDays[]={31,28,31,30,31,30,31,31,30,31,30,31}; // API starts months from 1, this array starts from 0
- 
 void breakTime(time_t timeInput, tmElements_t &tm){
 // break the given time_t into time components
 // this is a more compact version of the C library localtime function
 // note that year is offset from 1970 !!!
-
-  uint8_t year;
-  uint8_t month, monthLength;
-  uint32_t time;
-  unsigned long days;
-
-  time = (uint32_t)timeInput;
-  tm.Second = time % 60;
-  time /= 60; // now it is minutes
-  tm.Minute = time % 60;
-  time /= 60; // now it is hours
-  tm.Hour = time % 24;
-  time /= 24; // now it is days
-  tm.Wday = ((time + 4) % 7) + 1;  // Sunday is day 1 
-  
-  year = 0;  
-  days = 0;
-  while((unsigned)(days += (LEAP_YEAR(year) ? 366 : 365)) <= time) {
-    year++;
-  }
-  tm.Year = year; // year is offset from 1970 
-  
-  days -= LEAP_YEAR(year) ? 366 : 365;
-  time  -= days; // now it is days in this year, starting at 0
-  
-  days=0;
-  month=0;
-  monthLength=0;
-  for (month=0; month<12; month++) {
-    if (month==1) { // february
-      if (LEAP_YEAR(year)) {
-        monthLength=29;
-      } else {
-        monthLength=28;
-      }
-    } else {
-      monthLength = monthDays[month];
-    }
-    
-    if (time >= monthLength) {
-      time -= monthLength;
-    } else {
-        break;
-    }
+// constant time: no loops over years or months, correct for 64 bit time_t
+// (the uint8_t year offset limits the result to 1970-2225)
+
+  int64_t time = (int64_t)timeInput;
+  int64_t days = time / 86400;
+  int32_t secs = (int32_t)(time % 86400);
+  if (secs < 0) {  // floor division for times before 1970
+    secs += 86400;
+    days--;
   }
-  tm.Month = month + 1;  // jan is month 1  
-  tm.Day = time + 1;     // day of month
+
+  tm.Second = secs % 60;
+  secs /= 60; // now it is minutes
+  tm.Minute = secs % 60;
+  tm.Hour = secs / 60;
+  tm.Wday = weekdayFromDays(days);  // Sunday is day 1
+
+  // civil from days, see daysFromCivil() in TimeLib.h
+  int64_t z = civilShift(days);
+  int64_t doe = civilDayOfEra(z);                 // [0, 146096]
+  int64_t yoe = civilYearOfEra(doe);              // [0, 399]
+  int64_t doy = civilDayOfYear(doe);              // [0, 365], starts Mar 1
+  int64_t mp = (5 * doy + 2) / 153;               // [0, 11], starts Mar
+  uint8_t month = mp < 10 ? mp + 3 : mp - 9;
+  int64_t year = yoe + civilEraOfDays(z) * 400 + (month <= 2);
+
+  tm.Year = CalendarYrToTm(year); // year is offset from 1970
+  tm.Month = month;  // jan is month 1
+  tm.Day = doy - (153 * mp + 2) / 5 + 1;  // day of month
 }
 
 time_t makeTime(const tmElements_t &tm){   
 // assemble time elements into time_t 
 // note year argument is offset from 1970 (see macros in time.h to convert to other formats)
 // previous version used full four digit year (or digits since 2000),i.e. 2009 was 2009 or 9
-  
-  int i;
-  uint32_t seconds;
-
-  // seconds from 1970 till 1 jan 00:00:00 of the given year
-  seconds= tm.Year*(SECS_PER_DAY * 365);
-  for (i = 0; i < tm.Year; i++) {
-    if (LEAP_YEAR(i)) {
-      seconds += SECS_PER_DAY;   // add extra days for leap years
-    }
-  }
-  
-  // add days for this year, months start from 1
-  for (i = 1; i < tm.Month; i++) {
-    if ( (i == 2) && LEAP_YEAR(tm.Year)) { 
-      seconds += SECS_PER_DAY * 29;
-    } else {
-      seconds += SECS_PER_DAY * monthDays[i-1];  //monthDay array starts from 0
-    }
-  }
-  seconds+= (tm.Day-1) * SECS_PER_DAY;
-  seconds+= tm.Hour * SECS_PER_HOUR;
-  seconds+= tm.Minute * SECS_PER_MIN;
-  seconds+= tm.Second;
+// constant time, computed in 64 bits so years past 2106 do not wrap
+
+  int64_t days = daysFromCivil(tmYearToCalendar(tm.Year), tm.Month, tm.Day);
+  int64_t seconds = days * 86400;
+  seconds += tm.Hour * 3600L;
+  seconds += tm.Minute * 60L;
+  seconds += tm.Second;
   return (time_t)seconds; 
 }
 /*=====================================================*/	
 /* Low level system time functions  */
 
-static uint32_t sysTime = 0;
-static uint32_t prevMillis = 0;
-static uint32_t nextSyncTime = 0;
-static timeStatus_t Status = timeNotSet;
+// The clock is a 64 bit microsecond counter plus an offset:
+//   time = baseMicros + (counter - anchorCounter) + slew applied so far
+// so now() and nowMicros() cost one counter read and a division no matter how
+// long ago they were last called, and the sub-second remainder is kept.
+// Every change (set, step, slew) rebases the anchor to the current counter.
+//
+// Any task may read the clock. The state is published in two copies
+// (a seqcount latch): a writer updates one copy while readers use the other,
+// so a reader never waits for a writer, even a preempted lower priority one,
+// and only retries when a write completed during its copy. Writers are
+// serialized by a mutex; the sync provider is called outside it.
+
+#if defined(ESP_PLATFORM)
+#include <esp_timer.h>
+
+static int64_t defaultMicros() {
+  return esp_timer_get_time();  // 64 bit, does not wrap
+}
+#else
+// 32 bit millis() extended to 64 bits: valid while the clock is read at
+// least once every 49 days, as before (single threaded platforms)
+static int64_t defaultMicros() {
+  static uint32_t lastMillis = 0;
+  static int64_t highMillis = 0;
+  uint32_t ms = millis();
+  if (ms < lastMillis) {
+    highMillis += (int64_t)1 << 32;
+  }
+  lastMillis = ms;
+  return (highMillis + ms) * 1000;
+}
+#endif
 
-getExternalTime getTimePtr;  // pointer to external sync function
+struct ClockState {
+  getMicrosCounter counter;
+  int64_t baseMicros;     // microseconds since 1970 at anchorCounter
+  int64_t anchorCounter;  // counter value at the last change
+  int64_t slewMicros;     // correction still to be applied at anchorCounter
+  time_t nextSyncTime;
+  timeStatus_t status;
+#ifdef TIME_DRIFT_INFO
+  time_t unsyncedStart;      // the first valid time set
+  int64_t unsyncedCounter;   // counter value at that moment
+#endif
+};
+
+#ifdef TIME_DRIFT_INFO
+#define CLOCK_STATE_INIT {defaultMicros, 0, 0, 0, 0, timeNotSet, 0, 0}
+#else
+#define CLOCK_STATE_INIT {defaultMicros, 0, 0, 0, 0, timeNotSet}
+#endif
+
+static ClockState clockCopies[2] = {CLOCK_STATE_INIT, CLOCK_STATE_INIT};
+static std::atomic<uint32_t> clockSequence(0);  // even: readers use copy 0, odd: copy 1
+static std::mutex writerLock;
+static std::atomic<bool> syncing(false);       // a task is calling the sync provider
+
+static std::atomic<getExternalTime> getTimePtr(nullptr);  // pointer to external sync function
 //setExternalTime setTimePtr; // not used in this version
 
 #ifdef TIME_DRIFT_INFO   // define this to get drift data
-time_t sysUnsyncedTime = 0; // the time sysTime unadjusted by sync  
+time_t sysUnsyncedTime = 0; // the time sysTime unadjusted by sync (last reader wins)
 #endif
 
+static ClockState readClock() {
+  while (true) {
+    uint32_t sequence = clockSequence.load(std::memory_order_acquire);
+    ClockState state = clockCopies[sequence & 1];
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (clockSequence.load(std::memory_order_relaxed) == sequence) {
+      return state;
+    }
+  }
+}
+
+// with writerLock held
+static void publishClock(const ClockState &state) {
+  uint32_t sequence = clockSequence.load(std::memory_order_relaxed);
+  // release: the previous write of copy 1 must be visible before readers move there
+  clockSequence.store(sequence + 1, std::memory_order_release);  // readers move to copy 1
+  std::atomic_thread_fence(std::memory_order_release);
+  clockCopies[0] = state;
+  clockSequence.store(sequence + 2, std::memory_order_release);  // and back to copy 0
+  std::atomic_thread_fence(std::memory_order_release);
+  clockCopies[1] = state;
+}
+
+// part of the pending slew that elapsed counter time has already absorbed
+static int64_t slewApplied(const ClockState &state, int64_t elapsed) {
+  int64_t limit = elapsed * TIME_SLEW_RATE_PPM / 1000000;
+  if (state.slewMicros >= 0) {
+    return state.slewMicros < limit ? state.slewMicros : limit;
+  }
+  return -state.slewMicros < limit ? state.slewMicros : -limit;
+}
+
+static int64_t microsAt(const ClockState &state, int64_t counter) {
+  int64_t elapsed = counter - state.anchorCounter;
+  return state.baseMicros + elapsed + slewApplied(state, elapsed);
+}
+
+// move the anchor to the current counter, folding in the slew applied so far
+static void rebase(ClockState &state) {
+  int64_t counter = state.counter();
+  int64_t elapsed = counter - state.anchorCounter;
+  int64_t applied = slewApplied(state, elapsed);
+  state.baseMicros += elapsed + applied;
+  state.slewMicros -= applied;
+  state.anchorCounter = counter;
+}
+
+static time_t secondsOf(int64_t micros) {  // floor, also before 1970
+  return (time_t)(micros >= 0 ? micros / 1000000 : (micros - 999999) / 1000000);
+}
+
+int64_t nowMicros() {
+  ClockState state = readClock();
+  return microsAt(state, state.counter());
+}
+
+// the sync provider is due: one task calls it, the others keep the current time
+static time_t syncClock(time_t sysTime) {
+  getExternalTime provider = getTimePtr.load();
+  bool idle = false;
+  if (provider == 0 || !syncing.compare_exchange_strong(idle, true)) {
+    return sysTime;
+  }
+  time_t t = provider();
+  if (t != 0) {
+    setTime(t);
+    sysTime = t;
+  } else {
+    std::lock_guard<std::mutex> guard(writerLock);
+    ClockState state = clockCopies[1];  // copies are equal between writes
+    state.nextSyncTime = sysTime + syncInterval;
+    state.status = (state.status == timeNotSet) ?  timeNotSet : timeNeedsSync;
+    publishClock(state);
+  }
+  syncing.store(false);
+  return sysTime;
+}
 
 time_t now() {
-	// calculate number of seconds passed since last call to now()
-  while (millis() - prevMillis >= 1000) {
-		// millis() and prevMillis are both unsigned ints thus the subtraction will always be the absolute value of the difference
-    sysTime++;
-    prevMillis += 1000;	
+  ClockState state = readClock();
+  int64_t counter = state.counter();
+  time_t sysTime = secondsOf(microsAt(state, counter));
 #ifdef TIME_DRIFT_INFO
-    sysUnsyncedTime++; // this can be compared to the synced time to measure long term drift     
-#endif
+  if (state.unsyncedStart != 0) {  // this can be compared to the synced time to measure long term drift
+    sysUnsyncedTime = state.unsyncedStart + (time_t)((counter - state.unsyncedCounter) / 1000000);
   }
-  if (nextSyncTime <= sysTime) {
-    if (getTimePtr != 0) {
-      time_t t = getTimePtr();
-      if (t != 0) {
-        setTime(t);
-      } else {
-        nextSyncTime = sysTime + syncInterval;
-        Status = (Status == timeNotSet) ?  timeNotSet : timeNeedsSync;
-      }
-    }
+#endif
+  if (state.nextSyncTime <= sysTime) {
+    return syncClock(sysTime);
   }  
-  return (time_t)sysTime;
+  return sysTime;
 }
 
-void setTime(time_t t) { 
+void setTimeMicros(int64_t micros) {
+  std::lock_guard<std::mutex> guard(writerLock);
+  ClockState state = clockCopies[1];
 #ifdef TIME_DRIFT_INFO
- if(sysUnsyncedTime == 0) 
-   sysUnsyncedTime = t;   // store the time of the first call to set a valid Time   
+ if(state.unsyncedStart == 0) {
+   state.unsyncedStart = secondsOf(micros);   // store the time of the first call to set a valid Time   
+   state.unsyncedCounter = state.counter();
+ }
 #endif
 
-  sysTime = (uint32_t)t;  
-  nextSyncTime = (uint32_t)t + syncInterval;
-  Status = timeSet;
-  prevMillis = millis();  // restart counting from now (thanks to Korman for this fix)
+  state.anchorCounter = state.counter();  // restart counting from now
+  state.baseMicros = micros;
+  state.slewMicros = 0;
+  state.nextSyncTime = secondsOf(micros) + syncInterval;
+  state.status = timeSet;
+  publishClock(state);
+}
+
+void setTime(time_t t) { 
+  setTimeMicros((int64_t)t * 1000000);
 } 
 
 void setTime(int hr,int min,int sec,int dy, int mnth, int yr){
@@ -290,6 +377,7 @@ void setTime(int hr,int min,int sec,int dy, int mnth, int yr){
       yr = yr - 1970;
   else
       yr += 30;  
+  tmElements_t tm;
   tm.Year = yr;
   tm.Month = mnth;
   tm.Day = dy;
@@ -300,22 +388,60 @@ void setTime(int hr,int min,int sec,int dy, int mnth, int yr){
 }
 
 void adjustTime(long adjustment) {
-  sysTime += adjustment;
+  adjustTimeMicros((int64_t)adjustment * 1000000);
+}
+
+void adjustTimeMicros(int64_t adjustment) {
+  std::lock_guard<std::mutex> guard(writerLock);
+  ClockState state = clockCopies[1];
+  rebase(state);
+  state.baseMicros += adjustment;
+  publishClock(state);
+}
+
+void slewTime(int64_t adjustment) {
+  std::lock_guard<std::mutex> guard(writerLock);
+  ClockState state = clockCopies[1];
+  rebase(state);
+  state.slewMicros = adjustment;
+  publishClock(state);
+}
+
+int64_t slewRemaining() {
+  ClockState state = readClock();
+  return state.slewMicros - slewApplied(state, state.counter() - state.anchorCounter);
+}
+
+void setMicrosCounter(getMicrosCounter counter) {
+  std::lock_guard<std::mutex> guard(writerLock);
+  ClockState state = clockCopies[1];
+  rebase(state);
+  state.counter = counter != 0 ? counter : defaultMicros;
+  state.anchorCounter = state.counter();  // same time, new counter
+  publishClock(state);
 }
 
 // indicates if time has been set and recently synchronized
 timeStatus_t timeStatus() {
   now(); // required to actually update the status
-  return Status;
+  return readClock().status;
 }
 
 void setSyncProvider( getExternalTime getTimeFunction){
-  getTimePtr = getTimeFunction;  
-  nextSyncTime = sysTime;
+  getTimePtr.store(getTimeFunction);
+  {
+    std::lock_guard<std::mutex> guard(writerLock);
+    ClockState state = clockCopies[1];
+    state.nextSyncTime = secondsOf(microsAt(state, state.counter()));
+    publishClock(state);
+  }
   now(); // this will sync the clock
 }
 
 void setSyncInterval(time_t interval){ // set the number of seconds between re-sync
   syncInterval = (uint32_t)interval;
-  nextSyncTime = sysTime + syncInterval;
+  std::lock_guard<std::mutex> guard(writerLock);
+  ClockState state = clockCopies[1];
+  state.nextSyncTime = secondsOf(microsAt(state, state.counter())) + syncInterval;
+  publishClock(state);
 }
@@ -15,6 +15,7 @@
 #ifndef __AVR__
 #include <sys/types.h> // for __time_t_defined, but avr libc lacks sys/types.h
 #endif
+#include "TimeLocale.h"
 
 
 #if !defined(__time_t_defined) // avoid conflict with newlib or other posix libc
@@ -59,9 +60,15 @@ typedef struct  {
 #define  y2kYearToTm(Y)      ((Y) + 30)   
 
 typedef time_t(*getExternalTime)();
+typedef int64_t(*getMicrosCounter)();  // monotonic microsecond counter
 //typedef void  (*setExternalTime)(const time_t); // not used in this version
 
 
+// rate at which slewTime() corrections are applied (500 ppm as adjtime() on Linux)
+#ifndef TIME_SLEW_RATE_PPM
+#define TIME_SLEW_RATE_PPM 500
+#endif
+
 /*==============================================================================*/
 /* Useful Constants */
 #define SECS_PER_MIN  ((time_t)(60UL))
@@ -94,6 +101,34 @@ typedef time_t(*getExternalTime)();
 #define daysToTime_t    ((D)) ( (D) * SECS_PER_DAY) // fixed on Jul 22 2011
 #define weeksToTime_t   ((W)) ( (W) * SECS_PER_WEEK)   
 
+/*============================================================================*/
+/* decomposed time owned by the caller: each task keeps its own, so reading
+   the fields never races another task (hour(t) and friends use one per task) */
+class TimeFields {
+public:
+  TimeFields() {}
+  explicit TimeFields(time_t t) { set(t); }
+  void set(time_t t);  // breaks t down, unless it is the time already held
+
+  time_t time() const { return t; }
+  const tmElements_t &elements() const { return tm; }
+  int hour() const { return tm.Hour; }
+  int hourFormat12() const { return tm.Hour == 0 ? 12 : (tm.Hour > 12 ? tm.Hour - 12 : tm.Hour); }
+  uint8_t isAM() const { return tm.Hour < 12; }
+  uint8_t isPM() const { return tm.Hour >= 12; }
+  int minute() const { return tm.Minute; }
+  int second() const { return tm.Second; }
+  int day() const { return tm.Day; }
+  int weekday() const { return tm.Wday; }  // Sunday is day 1
+  int month() const { return tm.Month; }
+  int year() const { return tmYearToCalendar(tm.Year); }
+
+private:
+  time_t t = 0;
+  bool valid = false;
+  tmElements_t tm = {};
+};
+
 /*============================================================================*/
 /*  time and date functions   */
 int     hour();            // the hour now 
@@ -118,16 +153,26 @@ int     year();            // the full four digit year: (2009, 2010 etc)
 int     year(time_t t);    // the year for the given time
 
 time_t now();              // return the current time as seconds since Jan 1 1970 
+int64_t nowMicros();       // the current time as microseconds since Jan 1 1970
 void    setTime(time_t t);
 void    setTime(int hr,int min,int sec,int day, int month, int yr);
-void    adjustTime(long adjustment);
-
-/* date strings */ 
-#define dt_MAX_STRING_LEN 9 // length of longest date string (excluding terminating null)
-char* monthStr(uint8_t month);
-char* dayStr(uint8_t day);
-char* monthShortStr(uint8_t month);
-char* dayShortStr(uint8_t day);
+void    setTimeMicros(int64_t micros);        // set with the sub-second part
+void    adjustTime(long adjustment);          // step by whole seconds
+void    adjustTimeMicros(int64_t adjustment); // step by microseconds
+void    slewTime(int64_t adjustment);         // apply gradually at TIME_SLEW_RATE_PPM, replaces a pending slew
+int64_t slewRemaining();                      // microseconds of the slew not yet applied
+void    setMicrosCounter(getMicrosCounter counter); // clock source, 0 for the default (esp_timer or millis)
+
+/* date strings of the TIME_LOCALE locale, pointing into constant tables */ 
+#define dt_MAX_STRING_LEN TimeLocale::maxLength // longest date string of the locale (excluding terminating null)
+TimeText monthText(uint8_t month);
+TimeText dayText(uint8_t day);
+TimeText monthShortText(uint8_t month);
+TimeText dayShortText(uint8_t day);
+const char* monthStr(uint8_t month);
+const char* dayStr(uint8_t day);
+const char* monthShortStr(uint8_t month);
+const char* dayShortStr(uint8_t day);
 	
 /* time sync functions	*/
 timeStatus_t timeStatus(); // indicates if time has been set and recently synchronized
@@ -138,6 +183,47 @@ void    setSyncInterval(time_t interval); // set the number of seconds between r
 void breakTime(time_t time, tmElements_t &tm);  // break time_t into elements
 time_t makeTime(const tmElements_t &tm);  // convert time elements into time_t
 
+/* constant time calendar arithmetic on days since Jan 1 1970 (proleptic Gregorian)
+   valid for any 64 bit day count; usable in constant expressions */
+constexpr int64_t civilEra(int64_t y) { return (y >= 0 ? y : y - 399) / 400; }
+constexpr int64_t civilDaysFromEra(int64_t era, int64_t yoe, int64_t doy) {
+  return era * 146097 + yoe * 365 + yoe / 4 - yoe / 100 + doy - 719468;
+}
+constexpr int64_t civilDaysFromShiftedYear(int64_t y, unsigned m, unsigned d) {
+  return civilDaysFromEra(civilEra(y), y - civilEra(y) * 400, (153 * (m > 2 ? m - 3 : m + 9) + 2) / 5 + d - 1);
+}
+// days since Jan 1 1970 for the given year, month (1-12) and day (1-31)
+constexpr int64_t daysFromCivil(int64_t y, unsigned m, unsigned d) {
+  return civilDaysFromShiftedYear(y - (m <= 2 ? 1 : 0), m, d);
+}
+
+// helpers for the reverse conversion; z is the day count shifted to Mar 1 0000
+constexpr int64_t civilShift(int64_t days) { return days + 719468; }
+constexpr int64_t civilEraOfDays(int64_t z) { return (z >= 0 ? z : z - 146096) / 146097; }
+constexpr int64_t civilDayOfEra(int64_t z) { return z - civilEraOfDays(z) * 146097; }
+constexpr int64_t civilYearOfEra(int64_t doe) { return (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365; }
+constexpr int64_t civilDayOfYear(int64_t doe) {
+  return doe - (365 * civilYearOfEra(doe) + civilYearOfEra(doe) / 4 - civilYearOfEra(doe) / 100);
+}
+constexpr int64_t civilShiftedMonth(int64_t doe) { return (5 * civilDayOfYear(doe) + 2) / 153; }
+
+constexpr unsigned civilMonthFromDays(int64_t days) {  // 1-12
+  return (unsigned)(civilShiftedMonth(civilDayOfEra(civilShift(days))) < 10 ?
+                    civilShiftedMonth(civilDayOfEra(civilShift(days))) + 3 :
+                    civilShiftedMonth(civilDayOfEra(civilShift(days))) - 9);
+}
+constexpr unsigned civilDayFromDays(int64_t days) {    // 1-31
+  return (unsigned)(civilDayOfYear(civilDayOfEra(civilShift(days))) -
+                    (153 * civilShiftedMonth(civilDayOfEra(civilShift(days))) + 2) / 5 + 1);
+}
+constexpr int64_t civilYearFromDays(int64_t days) {    // full four digit year
+  return civilYearOfEra(civilDayOfEra(civilShift(days))) + civilEraOfDays(civilShift(days)) * 400 +
+         (civilMonthFromDays(days) <= 2 ? 1 : 0);
+}
+constexpr unsigned weekdayFromDays(int64_t days) {     // Sunday is day 1
+  return (unsigned)(days >= -4 ? (days + 4) % 7 : (days + 5) % 7 + 6) + 1;
+}
+
 } // extern "C++"
 #endif // __cplusplus
 #endif /* _Time_h */
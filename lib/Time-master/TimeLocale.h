@@ -0,0 +1,79 @@
+/*
+  TimeLocale.h - month and day names as views into constant tables
+
+  A locale is a struct of tables; the one used by monthStr(), dayStr() and
+  friends is chosen at compile time:
+    -DTIME_LOCALE=TimeLocalePl      (default TimeLocaleEn)
+  Letters outside ASCII are HD44780 CGRAM codes 1-7 (0 would end the string);
+  the locale lists their 5x8 bitmaps, so the display is set up from the same
+  definition with timeLocaleCreateChars(lcd).
+*/
+
+#ifndef _TimeLocale_h
+#define _TimeLocale_h
+
+#include <inttypes.h>
+
+extern "C++" {
+
+// name in a constant table: no copy, also NUL terminated
+struct TimeText {
+  const char *text;
+  uint8_t length;
+};
+
+// custom character used by a locale
+struct TimeGlyph {
+  uint8_t code;        // CGRAM location and character code (1-7)
+  uint8_t bitmap[8];   // 5x8 rows, top first
+  const char *utf8;    // the letter it stands for
+};
+
+// index 0 holds "" for months and "Err" for days, as before;
+// short names are exactly 3 characters; maxLength is the longest name
+// (without the terminating null), checked when the tables are compiled
+struct TimeLocaleEn {
+  static const TimeText months[13];
+  static const TimeText monthsShort[13];
+  static const TimeText days[8];       // Sunday is day 1
+  static const TimeText daysShort[8];
+  static const TimeGlyph *const glyphs;
+  static const uint8_t glyphCount = 0;
+  static const uint8_t maxLength = 9;   // "Wednesday", "September"
+};
+
+struct TimeLocalePl {
+  static const TimeText months[13];
+  static const TimeText monthsShort[13];
+  static const TimeText days[8];
+  static const TimeText daysShort[8];
+  static const TimeGlyph glyphs[5];
+  static const uint8_t glyphCount = 5;
+  static const uint8_t maxLength = 12;  // "Poniedziałek"
+};
+
+#ifndef TIME_LOCALE
+#define TIME_LOCALE TimeLocaleEn
+#endif
+typedef TIME_LOCALE TimeLocale;
+
+// loads the locale's glyphs into any LCD with createChar(location, bitmap)
+template <class Lcd>
+void timeLocaleCreateChars(Lcd &lcd) {
+  for (uint8_t i = 0; i < TimeLocale::glyphCount; i++) {
+    lcd.createChar(TimeLocale::glyphs[i].code, TimeLocale::glyphs[i].bitmap);
+  }
+}
+
+// the letter for a glyph code of the locale, 0 for other characters
+inline const char *timeLocaleGlyphUtf8(char c) {
+  for (uint8_t i = 0; i < TimeLocale::glyphCount; i++) {
+    if (TimeLocale::glyphs[i].code == (uint8_t)c) {
+      return TimeLocale::glyphs[i].utf8;
+    }
+  }
+  return 0;
+}
+
+} // extern "C++"
+#endif /* _TimeLocale_h */
@@ -0,0 +1,112 @@
+#include "GpsConfig.h"
+
+#include <esp_timer.h>
+
+static_assert(GPS_FIX_INTERVAL_MS * 1000L > GPS_BURST_GAP_US,
+              "GPS_BURST_GAP_US musi być krótszy niż okres fiksa");
+
+// Prędkości w kolejności sprawdzania
+static const uint32_t CANDIDATE_BAUDS[] = {GPS_DEFAULT_BAUD, GPS_CONFIG_BAUD};
+static const int CANDIDATE_COUNT = GPS_CONFIG_BAUD == GPS_DEFAULT_BAUD ? 1 : 2;
+
+// Numer prędkości w PCAS01
+static int pcasBaudCode(uint32_t baud) {
+  switch (baud) {
+    case 4800:   return 0;
+    case 9600:   return 1;
+    case 19200:  return 2;
+    case 38400:  return 3;
+    case 57600:  return 4;
+    case 115200: return 5;
+    default:     return -1;
+  }
+}
+
+void GpsConfig::start() {
+  state = CONFIG_DETECTING;
+  listen(CANDIDATE_BAUDS[0]);
+}
+
+void GpsConfig::listen(uint32_t baud) {
+  if (uart.baud() != baud) {
+    uart.setBaud(baud);
+  }
+  stateTime = millis();
+  listenUs = esp_timer_get_time();
+}
+
+void GpsConfig::step(const NmeaSentence &sentence, bool valid) {
+  if (state == CONFIG_IDLE || !valid || sentence.endUs < listenUs) {
+    return;
+  }
+  lastValidTime = millis();
+
+  if (state == CONFIG_DETECTING) {
+    detectedBaud = uart.baud();
+    configure();
+  } else if (state == CONFIG_VERIFYING) {
+    state = CONFIG_DONE;
+  }
+}
+
+void GpsConfig::poll() {
+  uint32_t now = millis();
+  switch (state) {
+    case CONFIG_DETECTING:
+      if (now - stateTime >= GPS_CONFIG_DETECT_MS) {
+        // Następna prędkość; bez odbiornika sprawdzamy je w kółko
+        int next = 0;
+        for (int i = 0; i < CANDIDATE_COUNT; i++) {
+          if (CANDIDATE_BAUDS[i] == uart.baud()) {
+            next = (i + 1) % CANDIDATE_COUNT;
+          }
+        }
+        listen(CANDIDATE_BAUDS[next]);
+      }
+      break;
+    case CONFIG_VERIFYING:
+      if (now - stateTime >= GPS_CONFIG_DETECT_MS) {
+        state = CONFIG_FALLBACK;
+        listen(detectedBaud);
+        lastValidTime = now;
+      }
+      break;
+    case CONFIG_DONE:
+    case CONFIG_FALLBACK:
+      if (now - lastValidTime >= GPS_CONFIG_LOST_MS) {
+        start();
+      }
+      break;
+    default:
+      break;
+  }
+}
+
+void GpsConfig::configure() {
+  // GGA i RMC co fiks; GLL, GSA, GSV, VTG, ZDA, ANT, DHV, LPS, UTC, GST wyłączone
+  send("PCAS03,1,0,0,0,1,0,0,0,0,0,,,0,0");
+
+  char body[24];
+  snprintf(body, sizeof(body), "PCAS02,%d", GPS_FIX_INTERVAL_MS);
+  send(body);
+
+  int code = pcasBaudCode(GPS_CONFIG_BAUD);
+  if (detectedBaud == GPS_CONFIG_BAUD || code < 0) {
+    state = CONFIG_DONE;
+    return;
+  }
+  snprintf(body, sizeof(body), "PCAS01,%d", code);
+  send(body);
+  state = CONFIG_VERIFYING;
+  listen(GPS_CONFIG_BAUD);
+}
+
+void GpsConfig::send(const char *body) {
+  uint8_t sum = 0;
+  for (const char *p = body; *p != '\0'; p++) {
+    sum ^= (uint8_t)*p;
+  }
+  char line[48];
+  int len = snprintf(line, sizeof(line), "$%s*%02X\r\n", body, sum);
+  uart.write(line, (size_t)len);
+}
@@ -0,0 +1,55 @@
+#include "GpsSync.h"
+
+#include <TimeLib.h>
+
+static int64_t fixSecond(const GnssFix &fix) {
+  return daysFromCivil(fix.year, fix.month, fix.day) * 86400 + fix.hour * 3600L + fix.minute * 60L +
+         fix.second;
+}
+
+void GpsSync::start(uint32_t timeoutMs, uint8_t minSatellites, bool provisional) {
+  state = SYNC_WAITING;
+  startTime = millis();
+  timeout = timeoutMs;
+  minSats = minSatellites;
+  allowProvisional = provisional;
+}
+
+void GpsSync::step(const GnssFix &fix) {
+  // Czas widziany przed start() nie jest już świeży
+  bool fresh = fix.timeSequence != lastTimeSequence;
+  lastTimeSequence = fix.timeSequence;
+  if (!fresh) {
+    return;
+  }
+
+  // Zgodny z poprzednim: następna sekunda w paczce o sekundę późniejszej
+  int64_t second = fixSecond(fix);
+  int64_t burstGapUs = fix.burstStartUs - lastBurstUs - 1000000;
+  bool consistent = second == lastSecond + 1 && burstGapUs > -SYNC_PROVISIONAL_TOLERANCE_US &&
+                    burstGapUs < SYNC_PROVISIONAL_TOLERANCE_US;
+  lastSecond = second;
+  lastBurstUs = fix.burstStartUs;
+  if (state != SYNC_WAITING) {
+    return;
+  }
+
+  bool fixed = fix.locationValid && fix.satellitesValid && fix.satellites >= minSats;
+  if (minSats == 0 || fixed) {
+    // Bez wymaganego fiksa czas tylko potwierdza zaufany zegar - jakość czasu
+    // tymczasowego podnosi dopiero fiks
+    quality = fixed || quality != TIER_PROVISIONAL ? TIER_FIX : TIER_PROVISIONAL;
+    commit(fix, quality);
+    state = SYNC_OK;
+  } else if (allowProvisional && consistent && quality == TIER_NONE) {
+    quality = TIER_PROVISIONAL;
+    commit(fix, quality);
+  }
+}
+
+void GpsSync::poll() {
+  if (state == SYNC_WAITING && timeout > 0 &&
+      (uint32_t)(millis() - startTime) >= timeout) {
+    state = SYNC_FAILED;
+  }
+}
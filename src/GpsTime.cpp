@@ -0,0 +1,60 @@
+#include "GpsTime.h"
+
+#include <esp_timer.h>
+#include "Holdover.h"
+
+// 64 bity nie zapisują się atomowo - odczyt i zapis w sekcji krytycznej
+static int64_t lastPpsUs = 0;
+static portMUX_TYPE ppsMux = portMUX_INITIALIZER_UNLOCKED;
+
+static void IRAM_ATTR onPps() {
+  int64_t nowUs = esp_timer_get_time();
+  portENTER_CRITICAL_ISR(&ppsMux);
+  lastPpsUs = nowUs;
+  portEXIT_CRITICAL_ISR(&ppsMux);
+}
+
+struct timeval gpsTimeToTimeval(time_t second, uint32_t fractionUs,
+                                int64_t refUs, int64_t latencyUs, int64_t nowUs) {
+  int64_t elapsedUs = (nowUs - refUs) + latencyUs + fractionUs;
+  struct timeval tv;
+  tv.tv_sec = second + (time_t)(elapsedUs / 1000000);
+  tv.tv_usec = (suseconds_t)(elapsedUs % 1000000);
+  if (tv.tv_usec < 0) {
+    tv.tv_sec--;
+    tv.tv_usec += 1000000;
+  }
+  return tv;
+}
+
+struct timeval gpsBurstToTimeval(time_t second, uint32_t fractionUs, int64_t burstStartUs,
+                                 int64_t ppsUs, int64_t nowUs) {
+  int64_t refUs = burstStartUs;
+  int64_t latencyUs = GPS_RECEIVER_LATENCY_US;
+
+  // Zbocze PPS tuż przed paczką oznacza dokładny początek zgłoszonej sekundy
+  if (ppsUs > 0 && ppsUs <= burstStartUs && burstStartUs - ppsUs < 1000000) {
+    refUs = ppsUs;
+    latencyUs = 0;
+  }
+  return gpsTimeToTimeval(second, fractionUs, refUs, latencyUs, nowUs);
+}
+
+void gpsTimeBegin() {
+  if (PPS_PIN >= 0) {
+    pinMode(PPS_PIN, INPUT);
+    attachInterrupt(digitalPinToInterrupt(PPS_PIN), onPps, RISING);
+  }
+}
+
+void gpsSetTime(time_t second, uint32_t fractionUs, int64_t burstStartUs, bool provisional) {
+  int64_t ppsUs = 0;
+  if (PPS_PIN >= 0) {
+    portENTER_CRITICAL(&ppsMux);
+    ppsUs = lastPpsUs;
+    portEXIT_CRITICAL(&ppsMux);
+  }
+
+  int64_t nowUs = esp_timer_get_time();
+  holdoverSync(gpsBurstToTimeval(second, fractionUs, burstStartUs, ppsUs, nowUs), nowUs, provisional);
+}
@@ -0,0 +1,200 @@
+#include "GpsUart.h"
+
+#include <esp_timer.h>
+
+// Rozmiar bufora kołowego sterownika UART (ok. 2 s danych przy 9600 bodów)
+static const int UART_RX_BUFFER = 2048;
+static const int UART_EVENT_QUEUE_LEN = 20;
+static const int UART_PATTERN_QUEUE_LEN = 20;
+
+bool GpsUart::begin(uint32_t baud, int rxPin, int txPin) {
+  uart_config_t config = {};
+  config.baud_rate = (int)baud;
+  config.data_bits = UART_DATA_8_BITS;
+  config.parity = UART_PARITY_DISABLE;
+  config.stop_bits = UART_STOP_BITS_1;
+  config.flow_ctrl = UART_HW_FLOWCTRL_DISABLE;
+  config.source_clk = UART_SCLK_APB;
+  currentBaud = baud;
+  charTimeUs = 10000000UL / baud;
+
+  if (uart_driver_install(port, UART_RX_BUFFER, 0, UART_EVENT_QUEUE_LEN, &eventQueue, 0) != ESP_OK) {
+    return false;
+  }
+  uart_param_config(port, &config);
+  uart_set_pin(port, txPin, rxPin, UART_PIN_NO_CHANGE, UART_PIN_NO_CHANGE);
+
+  // Zdarzenie UART_PATTERN_DET po każdym '\n' kończącym zdanie NMEA
+  uart_enable_pattern_det_baud_intr(port, '\n', 1, 9, 0, 0);
+  uart_pattern_queue_reset(port, UART_PATTERN_QUEUE_LEN);
+
+  sentenceQueue = xQueueCreate(GPS_SENTENCE_QUEUE_LEN, sizeof(NmeaSentence));
+  if (sentenceQueue == nullptr) {
+    return false;
+  }
+  return xTaskCreate(eventTask, "gpsUart", 3072, this, configMAX_PRIORITIES - 2, &task) == pdPASS;
+}
+
+void GpsUart::setBaud(uint32_t baud) {
+  uart_wait_tx_done(port, pdMS_TO_TICKS(100));
+  uart_set_baudrate(port, baud);
+  currentBaud = baud;
+  charTimeUs = 10000000UL / baud;
+
+  // Razem z danymi znikają pozycje '\n' - zdarzenia UART_PATTERN_DET z kolejki
+  // trafiłyby potem na pustą kolejkę pozycji i liczyły się jako przepełnienia
+  uart_flush_input(port);
+  uart_pattern_queue_reset(port, UART_PATTERN_QUEUE_LEN);
+  xQueueReset(eventQueue);
+  xQueueReset(sentenceQueue);
+}
+
+void GpsUart::write(const char *data, size_t len) {
+  uart_write_bytes(port, data, len);
+}
+
+bool GpsUart::read(NmeaSentence &sentence, TickType_t wait) {
+  return xQueueReceive(sentenceQueue, &sentence, wait) == pdTRUE;
+}
+
+void GpsUart::parsed(const NmeaSentence &sentence) {
+  uint32_t latency = (uint32_t)(esp_timer_get_time() - sentence.endUs);
+  portENTER_CRITICAL(&statsMux);
+  counters.lastLatencyUs = latency;
+  if (latency > counters.maxLatencyUs) {
+    counters.maxLatencyUs = latency;
+  }
+  counters.sumLatencyUs += latency;
+  portEXIT_CRITICAL(&statsMux);
+}
+
+GpsUartStats GpsUart::stats() const {
+  portENTER_CRITICAL(&statsMux);
+  GpsUartStats copy = counters;
+  portEXIT_CRITICAL(&statsMux);
+  return copy;
+}
+
+bool GpsUart::idle(int64_t nowUs) const {
+  size_t buffered = 0;
+  uart_get_buffered_data_len(port, &buffered);
+  portENTER_CRITICAL(&statsMux);
+  int64_t endUs = framer.lastEndUs;
+  portEXIT_CRITICAL(&statsMux);
+  return buffered == 0 && uxQueueMessagesWaiting(sentenceQueue) == 0 &&
+         nowUs - endUs > GPS_BURST_GAP_US;
+}
+
+int64_t GpsUart::lastBurstStartUs() const {
+  portENTER_CRITICAL(&statsMux);
+  int64_t startUs = framer.burstStartUs;
+  portEXIT_CRITICAL(&statsMux);
+  return startUs;
+}
+
+void GpsUart::eventTask(void *arg) {
+  static_cast<GpsUart *>(arg)->handleEvents();
+}
+
+void GpsUart::handleEvents() {
+  uart_event_t event;
+  while (true) {
+    if (xQueueReceive(eventQueue, &event, portMAX_DELAY) != pdTRUE) {
+      continue;
+    }
+    switch (event.type) {
+      case UART_PATTERN_DET:
+        readSentence();
+        break;
+      case UART_FIFO_OVF:
+      case UART_BUFFER_FULL:
+        dropInput();
+        break;
+      default:
+        // UART_DATA: bajty czekają w buforze do najbliższego '\n'
+        break;
+    }
+  }
+}
+
+void GpsBurstFramer::frame(NmeaSentence &sentence, int64_t handledUs, size_t bytesAfter,
+                           uint32_t charTimeUs) {
+  int64_t endUs = handledUs - (int64_t)bytesAfter * charTimeUs;
+  int64_t earliestUs = lastEndUs + (int64_t)sentence.len * charTimeUs;
+  if (endUs < earliestUs) {
+    endUs = earliestUs;
+  }
+  sentence.endUs = endUs;
+  sentence.startUs = endUs - (int64_t)sentence.len * charTimeUs;
+  if (sentence.startUs - lastEndUs > GPS_BURST_GAP_US) {
+    burstStartUs = sentence.startUs;
+  }
+  sentence.burstStartUs = burstStartUs;
+  lastEndUs = endUs;
+}
+
+void GpsUart::readSentence() {
+  // Najpierw zajętość bufora, potem czas: bajt, który dojdzie pomiędzy,
+  // przesunie koniec najwyżej o jeden znak później
+  size_t buffered = 0;
+  uart_get_buffered_data_len(port, &buffered);
+  int64_t handledUs = esp_timer_get_time();
+
+  int pos = uart_pattern_pop_pos(port);
+  if (pos < 0) {
+    // Kolejka pozycji przepełniona - nie wiemy, gdzie kończą się zdania
+    dropInput();
+    return;
+  }
+
+  NmeaSentence sentence;
+  size_t len = (size_t)pos + 1;  // razem z '\n'
+  if (len > GPS_SENTENCE_MAX) {
+    // Śmieci lub zdanie za długie - odrzucamy w całości
+    uint8_t scratch[64];
+    size_t left = len;
+    while (left > 0) {
+      size_t chunk = left < sizeof(scratch) ? left : sizeof(scratch);
+      uart_read_bytes(port, scratch, chunk, 0);
+      left -= chunk;
+    }
+    portENTER_CRITICAL(&statsMux);
+    counters.bytes += len;
+    counters.droppedBytes += len;
+    portEXIT_CRITICAL(&statsMux);
+    return;
+  }
+
+  sentence.len = (uint8_t)uart_read_bytes(port, (uint8_t *)sentence.data, len, 0);
+  sentence.data[sentence.len] = '\0';
+  size_t bytesAfter = buffered > len ? buffered - len : 0;
+
+  // Początek zdania liczymy wstecz od '\n' z prędkości łącza
+  portENTER_CRITICAL(&statsMux);
+  framer.frame(sentence, handledUs, bytesAfter, charTimeUs);
+  portEXIT_CRITICAL(&statsMux);
+
+  bool queued = xQueueSend(sentenceQueue, &sentence, 0) == pdTRUE;
+  portENTER_CRITICAL(&statsMux);
+  counters.bytes += sentence.len;
+  if (queued) {
+    counters.sentences++;
+  } else {
+    counters.droppedBytes += sentence.len;
+  }
+  portEXIT_CRITICAL(&statsMux);
+}
+
+void GpsUart::dropInput() {
+  size_t buffered = 0;
+  uart_get_buffered_data_len(port, &buffered);
+  uart_flush_input(port);
+  uart_pattern_queue_reset(port, UART_PATTERN_QUEUE_LEN);
+  xQueueReset(eventQueue);
+
+  portENTER_CRITICAL(&statsMux);
+  counters.overflowEvents++;
+  counters.bytes += buffered;
+  counters.droppedBytes += buffered;
+  portEXIT_CRITICAL(&statsMux);
+}
@@ -0,0 +1,152 @@
+#include "Hd44780.h"
+
+#include <Wire.h>
+
+// Linie PCF8574
+static const uint8_t PIN_RS = 0x01;
+static const uint8_t PIN_EN = 0x04;
+static const uint8_t PIN_BACKLIGHT = 0x08;
+
+// Rozkazy HD44780
+static const uint8_t CMD_CLEAR = 0x01;
+static const uint8_t CMD_ENTRY_MODE = 0x06;      // adres rośnie, bez przesuwu ekranu
+static const uint8_t CMD_DISPLAY_ON = 0x0C;      // ekran włączony, bez kursora
+static const uint8_t CMD_FUNCTION_4BIT = 0x28;   // 4 bity, 2 wiersze, 5x8
+static const uint8_t CMD_SET_CGRAM = 0x40;
+static const uint8_t CMD_SET_DDRAM = 0x80;
+
+// Czas wykonania czyszczenia ekranu [us]
+static const uint32_t CLEAR_US = 2000;
+
+// Bajty PCF8574 na półbajt (EN=1, EN=0) i na bajt HD44780; przy zmianie
+// RS dochodzi jeszcze jeden bajt
+static const uint8_t BYTES_PER_NIBBLE = 2;
+static const uint8_t BYTES_PER_BYTE = 2 * BYTES_PER_NIBBLE;
+
+static const uint8_t ROW_OFFSETS[] = {0x00, 0x40, 0x14, 0x54};
+
+Hd44780::Hd44780(uint8_t address, uint8_t cols, uint8_t rows)
+    : address(address), cols(cols), rows(rows), backlightBit(PIN_BACKLIGHT) {}
+
+void Hd44780::init() {
+  batchLength = 0;
+  delay(50);
+
+  // Przejście w tryb 4-bitowy z dowolnego stanu (nota katalogowa, rys. 24)
+  pushNibble(0x03, false);
+  sendBatch();
+  delayMicroseconds(4500);
+  pushNibble(0x03, false);
+  sendBatch();
+  delayMicroseconds(4500);
+  pushNibble(0x03, false);
+  sendBatch();
+  delayMicroseconds(150);
+  pushNibble(0x02, false);
+
+  pushByte(CMD_FUNCTION_4BIT, false);
+  pushByte(CMD_DISPLAY_ON, false);
+  pushByte(CMD_ENTRY_MODE, false);
+  sendBatch();
+  clear();
+}
+
+void Hd44780::clear() {
+  command(CMD_CLEAR);
+  delayMicroseconds(CLEAR_US);
+}
+
+void Hd44780::setCursor(uint8_t col, uint8_t row) {
+  command(cursorCommand(col, row));
+}
+
+void Hd44780::backlight() {
+  backlightBit = PIN_BACKLIGHT;
+  batch[batchLength++] = backlightBit;
+  sendBatch();
+}
+
+void Hd44780::noBacklight() {
+  backlightBit = 0;
+  batch[batchLength++] = backlightBit;
+  sendBatch();
+}
+
+void Hd44780::createChar(uint8_t location, const uint8_t charmap[8]) {
+  pushByte(CMD_SET_CGRAM | ((location & 7) << 3), false);
+  for (uint8_t i = 0; i < 8; i++) {
+    pushByte(charmap[i], true);
+  }
+  sendBatch();
+}
+
+size_t Hd44780::write(uint8_t c) {
+  pushByte(c, true);
+  sendBatch();
+  return 1;
+}
+
+size_t Hd44780::write(const uint8_t *data, size_t size) {
+  for (size_t i = 0; i < size; i++) {
+    pushByte(data[i], true);
+  }
+  sendBatch();
+  return size;
+}
+
+void Hd44780::writeAt(uint8_t col, uint8_t row, const char *text, uint8_t length) {
+  pushByte(cursorCommand(col, row), false);
+  for (uint8_t i = 0; i < length; i++) {
+    pushByte((uint8_t)text[i], true);
+  }
+  sendBatch();
+}
+
+uint8_t Hd44780::cursorCommand(uint8_t col, uint8_t row) const {
+  if (row >= rows) {
+    row = rows - 1;
+  }
+  return CMD_SET_DDRAM | (ROW_OFFSETS[row & 3] + col);
+}
+
+void Hd44780::command(uint8_t value) {
+  pushByte(value, false);
+  sendBatch();
+}
+
+void Hd44780::pushByte(uint8_t value, bool data) {
+  if (batchLength + BYTES_PER_BYTE + 1 > HD44780_I2C_BUFFER) {
+    sendBatch();
+  }
+  pushNibble(value >> 4, data);
+  pushNibble(value & 0x0F, data);
+}
+
+// Półbajt zatrzaskiwany opadającym zboczem EN. Między zatrzaśnięciami
+// mijają co najmniej dwa bajty I2C (>= 45 us przy 400 kHz), więcej niż
+// 37 us wykonania zapisu znaku, więc bufor nie potrzebuje opóźnień.
+void Hd44780::pushNibble(uint8_t nibble, bool data) {
+  uint8_t bits = (uint8_t)(nibble << 4) | backlightBit | (data ? PIN_RS : 0);
+  // RS ustalone przed narastającym zboczem EN
+  if (batchLength == 0 || (batch[batchLength - 1] & PIN_RS) != (bits & PIN_RS)) {
+    batch[batchLength++] = bits;
+  }
+  batch[batchLength++] = bits | PIN_EN;
+  batch[batchLength++] = bits;
+}
+
+void Hd44780::sendBatch() {
+  if (batchLength == 0) {
+    return;
+  }
+  Wire.beginTransmission(address);
+  Wire.write(batch, batchLength);
+  Wire.endTransmission();
+
+  // START, adres i dane po 9 bitów (z ACK), STOP
+  uint32_t bits = 9UL * (batchLength + 1) + 2;
+  counters.transactions++;
+  counters.bytes += batchLength;
+  counters.busUs += bits * 1000000UL / Wire.getClock();
+  batchLength = 0;
+}
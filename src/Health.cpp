@@ -0,0 +1,107 @@
+#include "Health.h"
+
+#include <esp_attr.h>
+#include <esp_system.h>
+
+static const uint32_t CHECK_INTERVAL_MS = 1000;
+static const uint32_t FAULT_MAGIC = 0x4845414c;   // "HEAL"
+
+// Powód restartu przetrwa restart programowy
+static RTC_NOINIT_ATTR uint32_t faultMagic;
+static RTC_NOINIT_ATTR uint32_t faultCode;
+
+static TaskHandle_t tasks[HEALTH_MAX_TASKS];
+static HealthStats stats = {};
+static uint32_t lastCheck = 0;
+static uint32_t lastPassed = 0;
+static uint32_t lastBytes = 0;
+static uint32_t lastValid = 0;      // millis() ostatniego poprawnego zdania
+static uint32_t lastData = 0;       // millis() ostatnich bajtów z UART
+
+// Cisza na UART dłuższa niż ta oznacza odłączony odbiornik, nie blokadę
+static const uint32_t DATA_TIMEOUT_MS = 10000;
+
+void healthBegin() {
+  stats.tasks = 0;
+  stats.resetReason = (uint8_t)esp_reset_reason();
+  stats.lastFault = HEALTH_OK;
+  if (faultMagic == FAULT_MAGIC && faultCode < HEALTH_FAULTS && stats.resetReason == ESP_RST_SW) {
+    stats.lastFault = (HealthFault)faultCode;
+  }
+  faultMagic = 0;
+  lastCheck = lastValid = lastData = millis();
+}
+
+void healthWatchTask(TaskHandle_t task) {
+  if (task != nullptr && stats.tasks < HEALTH_MAX_TASKS) {
+    tasks[stats.tasks] = task;
+    stats.stacks[stats.tasks].name = pcTaskGetName(task);
+    stats.tasks++;
+  }
+}
+
+HealthFault healthCheck(const GpsUartStats &uart, const GnssFix &fix) {
+  uint32_t now = millis();
+  if ((uint32_t)(now - lastCheck) < CHECK_INTERVAL_MS) {
+    return HEALTH_OK;
+  }
+  lastCheck = now;
+
+  stats.freeHeap = ESP.getFreeHeap();
+  stats.minFreeHeap = ESP.getMinFreeHeap();
+  stats.largestBlock = ESP.getMaxAllocHeap();
+  bool stackLow = false;
+  for (uint8_t i = 0; i < stats.tasks; i++) {
+    stats.stacks[i].freeBytes = uxTaskGetStackHighWaterMark(tasks[i]);
+    stackLow = stackLow || stats.stacks[i].freeBytes < HEALTH_MIN_STACK;
+  }
+  stats.uartOverflows = uart.overflowEvents;
+  stats.checksumPassed = fix.passedChecksum;
+  stats.checksumFailed = fix.failedChecksum;
+
+  // Zablokowany odbiór: bajty przychodzą, poprawnych zdań brak.
+  // Cisza na UART (odłączony odbiornik) nie jest powodem do restartu.
+  if (stats.checksumPassed != lastPassed) {
+    lastValid = now;
+  }
+  if (uart.bytes != lastBytes) {
+    lastData = now;
+  }
+  lastPassed = stats.checksumPassed;
+  lastBytes = uart.bytes;
+  stats.sinceValidMs = now - lastValid;
+
+  if (stats.freeHeap < HEALTH_MIN_FREE_HEAP) {
+    return HEALTH_HEAP;
+  }
+  if (stats.largestBlock < HEALTH_MIN_LARGEST_BLOCK) {
+    return HEALTH_FRAGMENTATION;
+  }
+  if (stackLow) {
+    return HEALTH_STACK;
+  }
+  if (stats.sinceValidMs >= HEALTH_GPS_STALL_MS && (uint32_t)(now - lastData) < DATA_TIMEOUT_MS) {
+    return HEALTH_GPS_STALLED;
+  }
+  return HEALTH_OK;
+}
+
+void healthRecordRestart(HealthFault fault) {
+  faultCode = fault;
+  faultMagic = FAULT_MAGIC;
+}
+
+const char *healthFaultName(HealthFault fault) {
+  switch (fault) {
+    case HEALTH_OK:            return "brak";
+    case HEALTH_HEAP:          return "sterta";
+    case HEALTH_FRAGMENTATION: return "fragmentacja";
+    case HEALTH_STACK:         return "stos";
+    case HEALTH_GPS_STALLED:   return "odbior GPS";
+    default:                   return "?";
+  }
+}
+
+HealthStats healthStats() {
+  return stats;
+}
@@ -0,0 +1,186 @@
+#include "Holdover.h"
+
+#include <esp_timer.h>
+#include <math.h>
+#include "Seqlock.h"
+
+// Co ile korekta częstotliwości trafia do adjtime()
+static const int64_t TICK_US = 1000000;
+
+// Waga nowego pomiaru dryftu i jego odchyłki w filtrze
+static const float PPM_GAIN = 0.5f;
+static const float ERROR_GAIN = 0.25f;
+static const float MIN_PPM_ERROR = 0.05f;
+
+static bool synced = false;       // zegar ustawiony (z GPS lub wznowiony po restarcie)
+static bool baseline = false;     // jest początek odcinka pomiaru dryftu
+static int64_t refTimerUs = 0;     // początek odcinka pomiaru dryftu (esp_timer)
+static int64_t refGpsUs = 0;       // j.w. czas GPS
+static int64_t syncTimerUs = 0;    // ostatnia synchronizacja (esp_timer)
+static int64_t lastTickUs = 0;
+static float correctionUs = 0;     // część korekty poniżej 1 us
+static uint32_t intervalMs = HOLDOVER_INITIAL_INTERVAL_MS;
+static HoldoverStats stats = {0.0f, HOLDOVER_INITIAL_PPM_ERROR, false, 0, 0, 0,
+                              HOLDOVER_INITIAL_INTERVAL_MS, 0, 0};
+
+// Migawka dla innych zadań (raport w loop); pisze zadanie zegara,
+// pierwszy raz holdoverResume() w setup()
+struct HoldoverSnapshot {
+  HoldoverStats stats;
+  bool synced;
+  int64_t syncTimerUs;
+};
+
+static Seqlock<HoldoverSnapshot> snapshot;
+
+static void publish() {
+  HoldoverSnapshot s;
+  s.stats = stats;
+  s.stats.intervalMs = intervalMs;
+  s.synced = synced;
+  s.syncTimerUs = syncTimerUs;
+  snapshot.write(s);
+}
+
+static int64_t toUs(const struct timeval &tv) {
+  return (int64_t)tv.tv_sec * 1000000 + tv.tv_usec;
+}
+
+static struct timeval fromUs(int64_t us) {
+  struct timeval tv;
+  tv.tv_sec = (time_t)(us / 1000000);
+  tv.tv_usec = (suseconds_t)(us % 1000000);
+  if (tv.tv_usec < 0) {
+    tv.tv_sec--;
+    tv.tv_usec += 1000000;
+  }
+  return tv;
+}
+
+// Nowy pomiar dryftu z odcinka ref -> teraz
+static void measureDrift(int64_t gpsUs, int64_t nowUs) {
+  int64_t timerSpan = nowUs - refTimerUs;
+  if (timerSpan < (int64_t)HOLDOVER_MIN_BASELINE_MS * 1000) {
+    return;
+  }
+  float ppm = (float)((double)(gpsUs - refGpsUs - timerSpan) * 1e6 / (double)timerSpan);
+  refTimerUs = nowUs;
+  refGpsUs = gpsUs;
+
+  if (!stats.ppmValid) {
+    stats.ppm = ppm;
+    stats.ppmValid = true;
+    return;
+  }
+  float innovation = ppm - stats.ppm;
+  stats.ppm += PPM_GAIN * innovation;
+  stats.ppmError += ERROR_GAIN * (fabsf(innovation) - stats.ppmError);
+  if (stats.ppmError < MIN_PPM_ERROR) {
+    stats.ppmError = MIN_PPM_ERROR;
+  }
+}
+
+// Interwał, po którym szacowany błąd osiągnie HOLDOVER_MAX_ERROR_US
+static void adaptInterval(int64_t offsetUs) {
+  if (stats.ppmValid) {
+    double seconds = HOLDOVER_MAX_ERROR_US / (double)stats.ppmError;
+    intervalMs = seconds * 1000 > HOLDOVER_MAX_INTERVAL_MS ? HOLDOVER_MAX_INTERVAL_MS
+                                                          : (uint32_t)(seconds * 1000);
+  }
+  if (llabs(offsetUs) > HOLDOVER_MAX_ERROR_US) {
+    intervalMs /= 2;   // poprzedni odcinek przekroczył dopuszczalny błąd
+  }
+  if (intervalMs < HOLDOVER_MIN_INTERVAL_MS) {
+    intervalMs = HOLDOVER_MIN_INTERVAL_MS;
+  }
+}
+
+void holdoverSync(const struct timeval &gps, int64_t nowUs, bool provisional) {
+  struct timeval system;
+  gettimeofday(&system, NULL);
+  int64_t gpsUs = toUs(gps) + (esp_timer_get_time() - nowUs);
+  int64_t offsetUs = gpsUs - toUs(system);
+
+  if (!synced || llabs(offsetUs) > HOLDOVER_STEP_US) {
+    struct timeval tv = fromUs(gpsUs);
+    settimeofday(&tv, NULL);   // kasuje też korektę w toku
+    stats.steps++;
+  } else {
+    // Nowa korekta zastępuje niedokończoną - przesunięcie zmierzono po niej
+    struct timeval delta = fromUs(offsetUs);
+    adjtime(&delta, NULL);
+  }
+
+  if (provisional) {
+    // Może brakować np. poprawki sekund przestępnych - nie do pomiaru dryftu
+    lastTickUs = nowUs;
+    synced = true;
+  } else if (!baseline) {
+    refTimerUs = nowUs;
+    refGpsUs = toUs(gps);
+    lastTickUs = nowUs;
+    synced = true;
+    baseline = true;
+  } else {
+    measureDrift(toUs(gps), nowUs);
+    adaptInterval(offsetUs);
+  }
+  syncTimerUs = nowUs;
+  stats.lastOffsetUs = (int32_t)offsetUs;
+  stats.syncs++;
+  publish();
+}
+
+void holdoverTick() {
+  int64_t nowUs = esp_timer_get_time();
+  if (!synced || !stats.ppmValid || nowUs - lastTickUs < TICK_US) {
+    return;
+  }
+  correctionUs += stats.ppm * (float)(nowUs - lastTickUs) / 1e6f;
+  lastTickUs = nowUs;
+  int64_t wholeUs = (int64_t)correctionUs;
+  if (wholeUs == 0) {
+    return;
+  }
+  correctionUs -= (float)wholeUs;
+
+  // adjtime() zastępuje korektę w toku - dodajemy jej resztę
+  struct timeval pending;
+  adjtime(NULL, &pending);
+  struct timeval delta = fromUs(toUs(pending) + wholeUs);
+  adjtime(&delta, NULL);
+}
+
+HoldoverState holdoverState() {
+  HoldoverState state = {stats.ppm, stats.ppmError, stats.ppmValid, intervalMs};
+  return state;
+}
+
+void holdoverResume(const HoldoverState &state, bool clockValid) {
+  stats.ppm = state.ppm;
+  stats.ppmError = state.ppmError;
+  stats.ppmValid = state.ppmValid;
+  intervalMs = state.intervalMs;
+  if (clockValid) {
+    synced = true;
+    syncTimerUs = esp_timer_get_time();
+    lastTickUs = syncTimerUs;
+  }
+  publish();
+}
+
+uint32_t holdoverInterval() {
+  return intervalMs;
+}
+
+HoldoverStats holdoverStats() {
+  HoldoverSnapshot s;
+  snapshot.read(s);
+  HoldoverStats copy = s.stats;
+  if (s.synced) {
+    int64_t sinceUs = esp_timer_get_time() - s.syncTimerUs;
+    copy.sinceSyncMs = (uint32_t)(sinceUs / 1000);
+    copy.estimatedErrorUs = (uint32_t)(copy.ppmError * (float)sinceUs / 1e6f);
+  }
+  return copy;
+}
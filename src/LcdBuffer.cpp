@@ -0,0 +1,99 @@
+#include "LcdBuffer.h"
+
+// Niezmienione znaki pomiędzy zmianami, które taniej wysłać niż przestawiać kursor
+static const uint8_t MAX_RUN_GAP = 1;
+
+void LcdBuffer::setCursor(uint8_t col, uint8_t row) {
+  cursorCol = col;
+  cursorRow = row;
+}
+
+size_t LcdBuffer::write(uint8_t c) {
+  if (cursorRow >= ROWS || cursorCol >= COLS) {
+    return 0;
+  }
+  layouts[cursorRow] = nullptr;
+  cells[cursorRow][cursorCol++] = (char)c;
+  return 1;
+}
+
+void LcdBuffer::clear() {
+  memset(cells, ' ', sizeof(cells));
+  memset(layouts, 0, sizeof(layouts));
+  cursorCol = 0;
+  cursorRow = 0;
+}
+
+char *LcdBuffer::row(uint8_t row, const char *layout) {
+  if (layouts[row] != layout) {
+    memcpy(cells[row], layout, COLS);
+    layouts[row] = layout;
+  }
+  return cells[row];
+}
+
+void LcdBuffer::invalidate() {
+  shownValid = false;
+  lcdCol = -1;
+  lcdRow = -1;
+}
+
+void LcdBuffer::flush() {
+  counters.flushes++;
+  uint32_t busBefore = lcd.stats().busUs;
+  for (uint8_t row = 0; row < ROWS; row++) {
+    if (!shownValid) {
+      sendRun(row, 0, COLS);
+      continue;
+    }
+
+    uint8_t col = 0;
+    while (col < COLS) {
+      if (cells[row][col] == shown[row][col]) {
+        col++;
+        continue;
+      }
+      // Rozszerzamy fragment o kolejne zmiany oddalone o <= MAX_RUN_GAP znaków
+      uint8_t end = col + 1;
+      uint8_t last = end;
+      while (end < COLS && end - last <= MAX_RUN_GAP) {
+        if (cells[row][end] != shown[row][end]) {
+          last = end + 1;
+        }
+        end++;
+      }
+      sendRun(row, col, last);
+      col = last;
+    }
+  }
+  shownValid = true;
+
+  uint32_t busUs = lcd.stats().busUs - busBefore;
+  counters.sumBusUs += busUs;
+  if (busUs > 0) {
+    counters.lastBusUs = busUs;
+    if (busUs > counters.maxBusUs) {
+      counters.maxBusUs = busUs;
+    }
+  }
+}
+
+LcdStats LcdBuffer::stats() const {
+  LcdStats result = counters;
+  result.bus = lcd.stats();
+  return result;
+}
+
+// Fragment wiersza idzie do LCD jedną transmisją I2C, razem z ustawieniem kursora
+void LcdBuffer::sendRun(uint8_t row, uint8_t from, uint8_t to) {
+  if (lcdRow != row || lcdCol != from) {
+    lcd.writeAt(from, row, &cells[row][from], to - from);
+    counters.commands++;
+  } else {
+    lcd.write((const uint8_t *)&cells[row][from], to - from);
+  }
+  memcpy(&shown[row][from], &cells[row][from], to - from);
+  counters.chars += to - from;
+  lcdRow = row;
+  lcdCol = to;
+}
@@ -0,0 +1,86 @@
+#include "LocalClock.h"
+#include "Timezone.h"
+
+// Największy skok do przodu liczony przez przenoszenie zamiast pełnej konwersji
+static const time_t MAX_CARRY_SECONDS = 60;
+
+static bool isLeapYear(int year) {
+  return (year % 4 == 0 && year % 100 != 0) || year % 400 == 0;
+}
+
+static int daysInMonth(int mon, int year) {
+  static const uint8_t days[] = {31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31};
+  return (mon == 1 && isLeapYear(year)) ? 29 : days[mon];
+}
+
+void LocalClock::update(time_t utc) {
+  if (valid && utc == current) {
+    return;
+  }
+  if (!valid || utc < current || utc - current > MAX_CARRY_SECONDS ||
+      (nextTransition != 0 && utc >= nextTransition)) {
+    convert(utc);
+    return;
+  }
+  while (current < utc) {
+    advanceSecond();
+  }
+}
+
+void LocalClock::convert(time_t utc) {
+  int64_t local = (int64_t)tzUtcToLocal(utc);
+  int64_t days = local / 86400;
+  int32_t secs = (int32_t)(local % 86400);
+  if (secs < 0) {
+    secs += 86400;
+    days--;
+  }
+
+  int year = (int)civilYearFromDays(days);
+  tm.tm_sec = secs % 60;
+  tm.tm_min = (secs / 60) % 60;
+  tm.tm_hour = secs / 3600;
+  tm.tm_mday = civilDayFromDays(days);
+  tm.tm_mon = civilMonthFromDays(days) - 1;
+  tm.tm_year = year - 1900;
+  tm.tm_wday = weekdayFromDays(days) - 1;
+  tm.tm_yday = (int)(days - daysFromCivil(year, 1, 1));
+  tm.tm_isdst = tzIsDst(utc) ? 1 : 0;
+
+  current = utc;
+  nextTransition = tzNextTransition(utc);
+  valid = true;
+  conversions++;
+}
+
+void LocalClock::advanceSecond() {
+  current++;
+  if (++tm.tm_sec < 60) {
+    return;
+  }
+  tm.tm_sec = 0;
+  if (++tm.tm_min < 60) {
+    return;
+  }
+  tm.tm_min = 0;
+  if (++tm.tm_hour < 24) {
+    return;
+  }
+  tm.tm_hour = 0;
+  advanceDay();
+}
+
+void LocalClock::advanceDay() {
+  tm.tm_wday = (tm.tm_wday + 1) % 7;
+  tm.tm_yday++;
+  if (++tm.tm_mday <= daysInMonth(tm.tm_mon, tm.tm_year + 1900)) {
+    return;
+  }
+  tm.tm_mday = 1;
+  if (++tm.tm_mon < 12) {
+    return;
+  }
+  tm.tm_mon = 0;
+  tm.tm_yday = 0;
+  tm.tm_year++;
+}
@@ -0,0 +1,242 @@
+#include "NmeaParser.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+static const uint32_t ONES = 0x01010101UL;
+
+// Maska 0x80 w bajtach słowa równych c (bez fałszywych trafień)
+static inline uint32_t matchBytes(uint32_t word, char c) {
+  uint32_t v = word ^ (ONES * (uint8_t)c);
+  uint32_t t = (v & 0x7F7F7F7FUL) + 0x7F7F7F7FUL;
+  return ~(t | v | 0x7F7F7F7FUL);
+}
+
+static inline uint32_t loadWord(const char *p) {
+  uint32_t word;
+  memcpy(&word, p, sizeof(word));
+  return word;
+}
+
+// Numer bajtu (w kolejności pamięci, little endian jak ESP32) pierwszego trafienia maski
+static inline uint8_t firstByte(uint32_t mask) {
+  return (uint8_t)(__builtin_ctz(mask) >> 3);
+}
+
+static int8_t hexValue(char c) {
+  if (c >= '0' && c <= '9') return c - '0';
+  if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+  if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+  return -1;
+}
+
+// Liczba całkowita z n cyfr; -1, gdy któryś znak nie jest cyfrą
+static int32_t digits(const char *p, uint8_t n) {
+  int32_t value = 0;
+  for (uint8_t i = 0; i < n; i++) {
+    uint8_t d = (uint8_t)(p[i] - '0');
+    if (d > 9) {
+      return -1;
+    }
+    value = value * 10 + d;
+  }
+  return value;
+}
+
+// Data istniejąca w kalendarzu; makeTime() przeniósłby 31.02 na marzec
+static bool validDate(int32_t d, int32_t m, int32_t y) {
+  static const uint8_t monthDays[12] = {31, 29, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31};
+  if (m < 1 || m > 12 || d < 1 || d > monthDays[m - 1]) {
+    return false;
+  }
+  bool leap = y % 4 == 0 && (y % 100 != 0 || y % 400 == 0);
+  return m != 2 || d <= 28 || leap;
+}
+
+// ddmm.mmmm / dddmm.mmmm + półkula -> stopnie
+static double nmeaDegrees(const char *raw) {
+  if (raw[0] == '\0') {
+    return 0.0;
+  }
+  const char *dot = strchr(raw, '.');
+  uint8_t degDigits = (uint8_t)((dot != nullptr ? dot - raw : (int)strlen(raw) - 1) - 2);
+  double deg = digits(raw, degDigits) + atof(raw + degDigits) / 60.0;
+  char hemisphere = raw[strlen(raw) - 1];
+  return (hemisphere == 'S' || hemisphere == 'W') ? -deg : deg;
+}
+
+double NmeaLocation::lat() {
+  updated = false;
+  return nmeaDegrees(rawLat);
+}
+
+double NmeaLocation::lng() {
+  updated = false;
+  return nmeaDegrees(rawLng);
+}
+
+bool NmeaParser::encode(const char *data, size_t len) {
+  chars += len;
+  if (len < 10 || data[0] != '$') {
+    return false;
+  }
+
+  // Suma XOR do '*' i pozycje przecinków - po 4 bajty naraz
+  uint32_t acc = 0;
+  size_t i = 1;
+  fields = 0;
+  starts[0] = 1;
+  while (i + 4 <= len) {
+    uint32_t word = loadWord(data + i);
+    if (matchBytes(word, '*') != 0) {
+      break;
+    }
+    uint32_t commas = matchBytes(word, ',');
+    while (commas != 0) {
+      if (fields < NMEA_MAX_FIELDS - 1) {
+        starts[++fields] = (uint8_t)(i + firstByte(commas) + 1);
+      }
+      commas &= commas - 1;
+    }
+    acc ^= word;
+    i += 4;
+  }
+  acc ^= acc >> 16;
+  acc ^= acc >> 8;
+  uint8_t sum = (uint8_t)acc;
+  for (; i < len && data[i] != '*'; i++) {
+    sum ^= (uint8_t)data[i];
+    if (data[i] == ',' && fields < NMEA_MAX_FIELDS - 1) {
+      starts[++fields] = (uint8_t)(i + 1);
+    }
+  }
+  if (i + 2 >= len || len > 255) {
+    failed++;
+    return false;
+  }
+  int8_t hi = hexValue(data[i + 1]);
+  int8_t lo = hexValue(data[i + 2]);
+  if (hi < 0 || lo < 0 || (uint8_t)(hi << 4 | lo) != sum) {
+    failed++;
+    return false;
+  }
+  passed++;
+  starts[++fields] = (uint8_t)(i + 1);  // koniec ostatniego pola
+
+  // Typ zdania bez identyfikatora systemu: $GPRMC, $GNRMC, $BDRMC...
+  sentence = data;
+  if (fieldLen(0) == 5) {
+    const char *type = field(0) + 2;
+    if (memcmp(type, "RMC", 3) == 0) {
+      parseRmc();
+    } else if (memcmp(type, "GGA", 3) == 0) {
+      parseGga();
+    } else if (memcmp(type, "ZDA", 3) == 0) {
+      parseZda();
+    }
+  }
+  return true;
+}
+
+bool NmeaParser::setTime(uint8_t i) {
+  uint8_t n = fieldLen(i);
+  if (n < 6) {
+    return false;
+  }
+  const char *p = field(i);
+  int32_t hms = digits(p, 6);
+  int32_t cs = 0;
+  if (n >= 9 && p[6] == '.') {
+    cs = digits(p + 7, 2);
+  } else if (n == 8 && p[6] == '.') {
+    cs = digits(p + 7, 1) * 10;
+  }
+  // Poprawna suma kontrolna nie wystarcza: 256199 ustawiłoby zły zegar
+  // (ss = 60 to sekunda przestępna)
+  if (hms < 0 || cs < 0 || cs > 99 || hms / 10000 > 23 || hms / 100 % 100 > 59 || hms % 100 > 60) {
+    return false;
+  }
+  time.raw = (uint32_t)hms * 100 + (uint32_t)cs;
+  time.commit();
+  return true;
+}
+
+void NmeaParser::setLocation(uint8_t latField) {
+  uint8_t latLen = fieldLen(latField);
+  uint8_t lngLen = fieldLen(latField + 2);
+  if (latLen == 0 || lngLen == 0 || (size_t)latLen + 1 >= sizeof(location.rawLat) ||
+      (size_t)lngLen + 1 >= sizeof(location.rawLng)) {
+    return;
+  }
+  memcpy(location.rawLat, field(latField), latLen);
+  location.rawLat[latLen] = *field(latField + 1);
+  location.rawLat[latLen + 1] = '\0';
+  memcpy(location.rawLng, field(latField + 2), lngLen);
+  location.rawLng[lngLen] = *field(latField + 3);
+  location.rawLng[lngLen + 1] = '\0';
+  location.commit();
+  // RMC i GGA tej samej sekundy to jeden fiks
+  if (time.raw != fixTime) {
+    fixTime = time.raw;
+    withFix++;
+  }
+}
+
+// $--RMC,hhmmss.ss,A,llll.ll,a,yyyyy.yy,a,x.x,x.x,ddmmyy,x.x,a,m*hh
+void NmeaParser::parseRmc() {
+  if (fields < 10) {
+    return;
+  }
+  setTime(1);
+  if (fieldLen(9) == 6) {
+    const char *p = field(9);
+    int32_t d = digits(p, 2);
+    int32_t m = digits(p + 2, 2);
+    int32_t y = digits(p + 4, 2);
+    if (y >= 0 && validDate(d, m, 2000 + y)) {
+      date.d = (uint8_t)d;
+      date.m = (uint8_t)m;
+      date.y = (uint16_t)(2000 + y);
+      date.commit();
+    }
+  }
+  if (fieldLen(2) == 1 && *field(2) == 'A') {
+    setLocation(3);
+  }
+}
+
+// $--GGA,hhmmss.ss,llll.ll,a,yyyyy.yy,a,q,nn,x.x,x.x,M,x.x,M,x.x,xxxx*hh
+void NmeaParser::parseGga() {
+  if (fields < 8) {
+    return;
+  }
+  setTime(1);
+  uint8_t n = fieldLen(7);
+  int32_t sats = n > 0 && n <= 2 ? digits(field(7), n) : -1;
+  if (sats >= 0) {
+    satellites.count = (uint8_t)sats;
+    satellites.commit();
+  }
+  if (fieldLen(6) == 1 && *field(6) > '0') {
+    setLocation(2);
+  }
+}
+
+// $--ZDA,hhmmss.ss,dd,mm,yyyy,zh,zm*hh
+void NmeaParser::parseZda() {
+  if (fields < 5) {
+    return;
+  }
+  if (!setTime(1) || fieldLen(2) != 2 || fieldLen(3) != 2 || fieldLen(4) != 4) {
+    return;
+  }
+  int32_t d = digits(field(2), 2);
+  int32_t m = digits(field(3), 2);
+  int32_t y = digits(field(4), 4);
+  if (y > 0 && validDate(d, m, y)) {
+    date.d = (uint8_t)d;
+    date.m = (uint8_t)m;
+    date.y = (uint16_t)y;
+    date.commit();
+  }
+}
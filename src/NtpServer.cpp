@@ -0,0 +1,222 @@
+#include "NtpServer.h"
+
+#include <WiFi.h>
+#include <errno.h>
+#include <lwip/sockets.h>
+#include <sys/time.h>
+#include "Seqlock.h"
+
+// Nad zadaniem ekranu (2): znacznik odbioru nie czeka na rysowanie,
+// a obsługa zapytania trwa mikrosekundy
+static const UBaseType_t NTP_TASK_PRIORITY = 3;
+
+// Limit czekania na datagram - co tyle sprawdzany jest stan WiFi
+static const uint32_t RECEIVE_TIMEOUT_MS = 1000;
+
+static const size_t NTP_PACKET_SIZE = 48;
+
+// Sekundy od 1900-01-01 do 1970-01-01
+static const uint32_t NTP_UNIX_OFFSET = 2208988800UL;
+
+// Pola nagłówka
+static const uint8_t LEAP_NONE = 0;
+static const uint8_t LEAP_ALARM = 3;     // zegar niezsynchronizowany
+static const uint8_t MODE_CLIENT = 3;
+static const uint8_t MODE_SERVER = 4;
+static const uint8_t VERSION = 4;
+static const uint8_t STRATUM_GPS = 1;
+static const uint8_t STRATUM_UNSYNC = 16;
+static const int8_t PRECISION = -20;     // 2^-20 s ~ 1 us (rozdzielczość gettimeofday)
+
+// Przesunięcia pól w pakiecie
+static const uint8_t OFFSET_ROOT_DISPERSION = 8;
+static const uint8_t OFFSET_REFERENCE_ID = 12;
+static const uint8_t OFFSET_REFERENCE = 16;
+static const uint8_t OFFSET_ORIGINATE = 24;
+static const uint8_t OFFSET_RECEIVE = 32;
+static const uint8_t OFFSET_TRANSMIT = 40;
+
+// Gotowa odpowiedź bez znaczników czasu zapytania
+struct NtpTemplate {
+  uint8_t packet[NTP_PACKET_SIZE];
+};
+
+static Seqlock<NtpTemplate> replyTemplate;
+static TaskHandle_t task = nullptr;
+static NtpServerStats stats = {};               // tylko zadanie ntp
+static Seqlock<NtpServerStats> statsShared;      // kopia dla ntpServerStats()
+
+static void putU32(uint8_t *p, uint32_t value) {
+  p[0] = (uint8_t)(value >> 24);
+  p[1] = (uint8_t)(value >> 16);
+  p[2] = (uint8_t)(value >> 8);
+  p[3] = (uint8_t)value;
+}
+
+static void putTimestamp(uint8_t *p, const struct timeval &tv) {
+  putU32(p, (uint32_t)tv.tv_sec + NTP_UNIX_OFFSET);
+  putU32(p + 4, (uint32_t)(((uint64_t)tv.tv_usec << 32) / 1000000));
+}
+
+// Szablon dla zegara nieustawionego
+static void buildUnsynced(NtpTemplate &t) {
+  memset(t.packet, 0, sizeof(t.packet));
+  t.packet[0] = (uint8_t)(LEAP_ALARM << 6 | VERSION << 3 | MODE_SERVER);
+  t.packet[1] = STRATUM_UNSYNC;
+  t.packet[3] = (uint8_t)PRECISION;
+  memcpy(t.packet + OFFSET_REFERENCE_ID, "INIT", 4);
+}
+
+void ntpServerUpdate(GpsSyncTier tier, const HoldoverStats &holdover) {
+  NtpTemplate t;
+  buildUnsynced(t);
+  uint32_t errorUs = GPS_SYNC_ERROR_US + holdover.estimatedErrorUs;
+
+  // Czas tymczasowy (bez fiksa) może nie mieć poprawki sekund przestępnych
+  if (tier == TIER_FIX && errorUs <= NTP_MAX_ERROR_US) {
+    t.packet[0] = (uint8_t)(LEAP_NONE << 6 | VERSION << 3 | MODE_SERVER);
+    t.packet[1] = STRATUM_GPS;
+    memcpy(t.packet + OFFSET_REFERENCE_ID, "GPS\0", 4);
+
+    // Dyspersja w formacie 16.16 s
+    putU32(t.packet + OFFSET_ROOT_DISPERSION, (uint32_t)(((uint64_t)errorUs << 16) / 1000000));
+
+    struct timeval now;
+    gettimeofday(&now, NULL);
+    int64_t referenceUs = (int64_t)now.tv_sec * 1000000 + now.tv_usec - (int64_t)holdover.sinceSyncMs * 1000;
+    struct timeval reference;
+    reference.tv_sec = (time_t)(referenceUs / 1000000);
+    reference.tv_usec = (suseconds_t)(referenceUs % 1000000);
+    putTimestamp(t.packet + OFFSET_REFERENCE, reference);
+  }
+  replyTemplate.write(t);
+}
+
+static int openSocket() {
+  int sock = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+  if (sock < 0) {
+    return -1;
+  }
+  int reuse = 1;
+  setsockopt(sock, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+  struct timeval timeout;
+  timeout.tv_sec = RECEIVE_TIMEOUT_MS / 1000;
+  timeout.tv_usec = (RECEIVE_TIMEOUT_MS % 1000) * 1000;
+  setsockopt(sock, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+
+  struct sockaddr_in address;
+  memset(&address, 0, sizeof(address));
+  address.sin_family = AF_INET;
+  address.sin_port = htons(NTP_PORT);
+  address.sin_addr.s_addr = htonl(INADDR_ANY);
+  if (bind(sock, (struct sockaddr *)&address, sizeof(address)) < 0) {
+    close(sock);
+    return -1;
+  }
+  return sock;
+}
+
+// Odpowiedź na jedno zapytanie; znacznik odbioru wzięty zaraz po recvfrom()
+static void serve(int sock, const uint8_t *request, int length, const struct timeval &received,
+                  const struct sockaddr_in &client) {
+  stats.requests++;
+  if (length < (int)NTP_PACKET_SIZE || (request[0] & 0x07) != MODE_CLIENT) {
+    stats.ignored++;
+    return;
+  }
+
+  NtpTemplate reply;
+  replyTemplate.read(reply);
+  uint8_t *p = reply.packet;
+  p[0] = (uint8_t)((p[0] & 0xC7) | (request[0] & 0x38));   // wersja jak w zapytaniu
+  p[2] = request[2];                                         // poll
+  memcpy(p + OFFSET_ORIGINATE, request + OFFSET_TRANSMIT, 8);
+  putTimestamp(p + OFFSET_RECEIVE, received);
+  stats.stratum = p[1];
+
+  struct timeval transmit;
+  gettimeofday(&transmit, NULL);
+  putTimestamp(p + OFFSET_TRANSMIT, transmit);
+  if (sendto(sock, p, NTP_PACKET_SIZE, 0, (const struct sockaddr *)&client, sizeof(client)) < 0) {
+    return;
+  }
+
+  uint32_t serviceUs = (uint32_t)((transmit.tv_sec - received.tv_sec) * 1000000L +
+                                  (transmit.tv_usec - received.tv_usec));
+  stats.replies++;
+  stats.lastServiceUs = serviceUs;
+  stats.sumServiceUs += serviceUs;
+  if (serviceUs > stats.maxServiceUs) {
+    stats.maxServiceUs = serviceUs;
+  }
+}
+
+static void ntpTask(void *) {
+  int sock = -1;
+  uint8_t request[NTP_PACKET_SIZE];
+  while (true) {
+    if (WiFi.status() != WL_CONNECTED) {
+      if (sock >= 0) {
+        close(sock);
+        sock = -1;
+      }
+      if (stats.connected) {
+        stats.connected = false;
+        statsShared.write(stats);
+      }
+      vTaskDelay(pdMS_TO_TICKS(RECEIVE_TIMEOUT_MS));
+      continue;
+    }
+    if (sock < 0) {
+      sock = openSocket();
+      if (sock < 0) {
+        vTaskDelay(pdMS_TO_TICKS(RECEIVE_TIMEOUT_MS));
+        continue;
+      }
+      stats.connected = true;
+      statsShared.write(stats);
+    }
+
+    struct sockaddr_in client;
+    socklen_t clientLength = sizeof(client);
+    int length = recvfrom(sock, request, sizeof(request), 0, (struct sockaddr *)&client, &clientLength);
+    struct timeval received;
+    gettimeofday(&received, NULL);
+    if (length < 0) {
+      if (errno != EAGAIN && errno != EWOULDBLOCK) {
+        close(sock);   // gniazdo zepsute (np. zerwane WiFi) - otwieramy od nowa
+        sock = -1;
+        stats.connected = false;
+        statsShared.write(stats);
+      }
+      continue;
+    }
+    serve(sock, request, length, received, client);
+    statsShared.write(stats);
+  }
+}
+
+void ntpServerBegin() {
+  if (!NTP_SERVER_ENABLE) {
+    return;
+  }
+  NtpTemplate t;
+  buildUnsynced(t);
+  replyTemplate.write(t);
+
+  // Bez oszczędzania energii modemu: uśpione radio opóźnia odbiór o okres DTIM
+  WiFi.mode(WIFI_STA);
+  WiFi.setSleep(false);
+  WiFi.begin(NTP_WIFI_SSID, NTP_WIFI_PASSWORD);
+  xTaskCreate(ntpTask, "ntp", 3072, nullptr, NTP_TASK_PRIORITY, &task);
+}
+
+TaskHandle_t ntpServerTask() {
+  return task;
+}
+
+NtpServerStats ntpServerStats() {
+  NtpServerStats copy;
+  statsShared.read(copy);
+  return copy;
+}
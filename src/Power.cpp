@@ -0,0 +1,117 @@
+#include "Power.h"
+
+#include <esp_freertos_hooks.h>
+#include <esp_pm.h>
+#include <esp_sleep.h>
+#include <esp_timer.h>
+#include <sdkconfig.h>
+#include <sys/time.h>
+
+// Automatyczny light sleep wymaga PM i tickless idle w konfiguracji IDF;
+// bez nich usypiamy CPU jawnie przez esp_light_sleep_start()
+#if defined(CONFIG_PM_ENABLE) && defined(CONFIG_FREERTOS_USE_TICKLESS_IDLE)
+#define POWER_AUTO_LIGHT_SLEEP 1
+#else
+#define POWER_AUTO_LIGHT_SLEEP 0
+#endif
+
+// Nie usypiamy na krócej niż koszt wejścia i wyjścia ze snu
+static const int64_t MIN_SLEEP_US = 5000;
+
+// Budzimy się chwilę przed pełną sekundą, żeby zdążyć przed paczką NMEA
+static const int64_t WAKE_GUARD_US = 2000;
+
+// Paczka NMEA przychodzi kilkadziesiąt ms po pełnej sekundzie; po przebudzeniu
+// nie usypiamy, dopóki nie odbierzemy paczki tej sekundy albo nie minie ten czas
+// (odbiornik milczy) - inaczej paczkę budziłby UART kosztem pierwszych znaków
+static const int64_t BURST_TIMEOUT_US = 400000;
+
+static const TickType_t IDLE_WAIT = pdMS_TO_TICKS(20);
+
+// Ile bajtów (zboczy RX) budzi CPU - te znaki są tracone
+static const int UART_WAKE_THRESHOLD = 3;
+
+static int64_t startUs = 0;
+static uint64_t sleepUs = 0;
+static uint32_t sleeps = 0;
+static TaskHandle_t idleTask = nullptr;
+static volatile uint32_t ticks = 0;
+static volatile uint32_t idleTicks = 0;
+
+// Próbkowanie obciążenia: które zadanie działa w chwili ticku
+static void IRAM_ATTR onTick() {
+  ticks++;
+  if (xTaskGetCurrentTaskHandle() == idleTask) {
+    idleTicks++;
+  }
+}
+
+void powerBegin() {
+  startUs = esp_timer_get_time();
+  sleepUs = 0;
+  sleeps = 0;
+  idleTask = xTaskGetIdleTaskHandle();
+  esp_register_freertos_tick_hook(onTick);
+  if (!LOW_POWER_MODE) {
+    return;
+  }
+
+  setCpuFrequencyMhz(LOW_POWER_CPU_MHZ);
+#if POWER_AUTO_LIGHT_SLEEP
+  esp_pm_config_esp32s2_t config = {};
+  config.max_freq_mhz = LOW_POWER_CPU_MHZ;
+  config.min_freq_mhz = LOW_POWER_CPU_MHZ;
+  config.light_sleep_enable = true;
+  esp_pm_configure(&config);
+#endif
+}
+
+// Czy wolno już spać w tej sekundzie zegara systemowego: paczka po ostatniej
+// pełnej sekundzie odebrana (albo minął BURST_TIMEOUT_US) i UART bezczynny
+static bool burstDone(GpsUart &uart, int64_t nowUs, const struct timeval &tv) {
+  int64_t edgeUs = nowUs - tv.tv_usec;
+  bool burstSeen = uart.lastBurstStartUs() >= edgeUs - WAKE_GUARD_US ||
+                   tv.tv_usec > BURST_TIMEOUT_US;
+  return burstSeen && uart.idle(nowUs);
+}
+
+static void lightSleep(GpsUart &uart, int64_t durationUs) {
+  esp_sleep_enable_timer_wakeup((uint64_t)durationUs);
+  uart_set_wakeup_threshold(uart.uartPort(), UART_WAKE_THRESHOLD);
+  esp_sleep_enable_uart_wakeup(uart.uartPort());
+
+  int64_t before = esp_timer_get_time();
+  esp_light_sleep_start();
+  sleepUs += (uint64_t)(esp_timer_get_time() - before);
+  sleeps++;
+}
+
+void powerIdle(GpsUart &uart, bool clockValid, TaskHandle_t wake) {
+  // Przy automatycznym light sleep wystarcza blokowanie - usypia zadanie bezczynności
+  if (LOW_POWER_MODE && !POWER_AUTO_LIGHT_SLEEP && clockValid) {
+    struct timeval tv;
+    gettimeofday(&tv, NULL);
+    int64_t nowUs = esp_timer_get_time();
+    int64_t untilEdge = 1000000 - tv.tv_usec;
+    if (untilEdge - WAKE_GUARD_US > MIN_SLEEP_US && burstDone(uart, nowUs, tv)) {
+      lightSleep(uart, untilEdge - WAKE_GUARD_US);
+      if (wake != nullptr) {
+        xTaskNotify(wake, 0, eNoAction);
+      }
+      return;
+    }
+  }
+  vTaskDelay(IDLE_WAIT);
+}
+
+PowerStats powerStats() {
+  PowerStats stats;
+  stats.totalUs = (uint64_t)(esp_timer_get_time() - startUs);
+  uint32_t sampled = ticks;
+  uint64_t awakeUs = stats.totalUs - sleepUs;
+  stats.idleUs = sleepUs + (sampled ? awakeUs * idleTicks / sampled : 0);
+  stats.sleepUs = sleepUs;
+  stats.sleeps = sleeps;
+  stats.cpuMhz = getCpuFrequencyMhz();
+  return stats;
+}
@@ -0,0 +1,81 @@
+#include "SerialFrame.h"
+
+static const uint8_t FRAME_SYNC0 = 0xA5;
+static const uint8_t FRAME_SYNC1 = 0x5A;
+static const size_t FRAME_OVERHEAD = 7;
+
+// Stany odbioru
+enum : uint8_t { WAIT_SYNC0, WAIT_SYNC1, HEADER, PAYLOAD, TRAILER };
+
+static uint16_t fletcher16(const uint8_t *data, size_t len, uint16_t state) {
+  uint16_t a = state & 0xff;
+  uint16_t b = state >> 8;
+  for (size_t i = 0; i < len; i++) {
+    a = (a + data[i]) % 255;
+    b = (b + a) % 255;
+  }
+  return (uint16_t)(b << 8 | a);
+}
+
+void serialFrameSend(uint8_t type, const uint8_t *payload, uint16_t len) {
+  if (len > SERIAL_FRAME_MAX_PAYLOAD) {
+    return;
+  }
+  uint8_t frame[SERIAL_FRAME_MAX_PAYLOAD + FRAME_OVERHEAD];
+  frame[0] = FRAME_SYNC0;
+  frame[1] = FRAME_SYNC1;
+  frame[2] = type;
+  frame[3] = (uint8_t)len;
+  frame[4] = (uint8_t)(len >> 8);
+  memcpy(frame + 5, payload, len);
+  uint16_t check = fletcher16(frame + 2, 3 + len, 0);
+  frame[5 + len] = (uint8_t)check;
+  frame[6 + len] = (uint8_t)(check >> 8);
+  Serial.write(frame, len + FRAME_OVERHEAD);
+}
+
+bool SerialFrameReader::push(uint8_t byte) {
+  switch (state) {
+    case WAIT_SYNC0:
+      if (byte == FRAME_SYNC0) {
+        state = WAIT_SYNC1;
+      }
+      return false;
+    case WAIT_SYNC1:
+      state = byte == FRAME_SYNC1 ? HEADER : (byte == FRAME_SYNC0 ? WAIT_SYNC1 : WAIT_SYNC0);
+      pos = 0;
+      return false;
+    case HEADER:
+      header[pos++] = byte;
+      if (pos == sizeof(header)) {
+        len = (uint16_t)(header[1] | header[2] << 8);
+        pos = 0;
+        if (len > SERIAL_FRAME_MAX_RX) {
+          bad++;
+          state = WAIT_SYNC0;
+        } else {
+          state = len > 0 ? PAYLOAD : TRAILER;
+        }
+      }
+      return false;
+    case PAYLOAD:
+      data[pos++] = byte;
+      if (pos == len) {
+        pos = 0;
+        state = TRAILER;
+      }
+      return false;
+    default:
+      trailer[pos++] = byte;
+      if (pos < sizeof(trailer)) {
+        return false;
+      }
+      state = WAIT_SYNC0;
+      uint16_t check = fletcher16(data, len, fletcher16(header, sizeof(header), 0));
+      if (check != (uint16_t)(trailer[0] | trailer[1] << 8)) {
+        bad++;
+        return false;
+      }
+      return true;
+  }
+}
@@ -0,0 +1,138 @@
+#include "TimeLink.h"
+
+#include <USBCDC.h>
+#include <sys/time.h>
+#include "GpsTime.h"
+#include "Seqlock.h"
+#include "SerialFrame.h"
+
+// Jak serwer NTP: nad zadaniem ekranu (2), obsługa trwa mikrosekundy
+static const UBaseType_t TIME_LINK_TASK_PRIORITY = 3;
+
+// Słowo jakości odpowiedzi; pisze tylko zadanie zegara
+struct TimeLinkQuality {
+  uint8_t flags;
+  uint8_t satellites;
+  uint32_t sinceSyncMs;
+  uint32_t errorUs;
+};
+
+static Seqlock<TimeLinkQuality> quality;
+static SerialFrameReader reader;
+static TaskHandle_t task = nullptr;
+static TimeLinkStats stats = {};               // tylko zadanie timeLink
+static Seqlock<TimeLinkStats> statsShared;      // kopia dla timeLinkStats()
+
+static void putU16(uint8_t *p, uint16_t value) {
+  p[0] = (uint8_t)value;
+  p[1] = (uint8_t)(value >> 8);
+}
+
+static void putU32(uint8_t *p, uint32_t value) {
+  putU16(p, (uint16_t)value);
+  putU16(p + 2, (uint16_t)(value >> 16));
+}
+
+static void putTime(uint8_t *p, const struct timeval &tv) {
+  putU32(p, (uint32_t)tv.tv_sec);
+  putU32(p + 4, (uint32_t)tv.tv_usec);
+}
+
+void timeLinkUpdate(bool clockSet, GpsSyncTier tier, GpsSyncStatus status, const GnssFix &fix,
+                    const HoldoverStats &holdover) {
+  TimeLinkQuality q;
+  q.flags = 0;
+  if (clockSet) {
+    q.flags |= TIME_LINK_CLOCK_SET;
+  }
+  if (tier == TIER_FIX) {
+    q.flags |= TIME_LINK_FIX;
+  } else if (tier == TIER_PROVISIONAL) {
+    q.flags |= TIME_LINK_PROVISIONAL;
+  }
+  if (status == SYNC_FAILED) {
+    q.flags |= TIME_LINK_SYNC_FAILED;
+  }
+  q.satellites = fix.satellitesValid ? fix.satellites : 0;
+  q.sinceSyncMs = holdover.sinceSyncMs;
+  q.errorUs = GPS_SYNC_ERROR_US + holdover.estimatedErrorUs;
+  quality.write(q);
+}
+
+// Odpowiedź na jedno zapytanie (dane już sprawdzone)
+static void reply(const uint8_t *poll, const struct timeval &received) {
+  TimeLinkQuality q;
+  quality.read(q);
+
+  uint8_t payload[TIME_LINK_REPLY_SIZE];
+  memcpy(payload, poll, TIME_LINK_POLL_SIZE);   // numer i znacznik hosta
+  putTime(payload + 12, received);
+  payload[28] = q.flags;
+  payload[29] = q.satellites;
+  putU16(payload + 30, 0);
+  putU32(payload + 32, q.sinceSyncMs);
+  putU32(payload + 36, q.errorUs);
+
+  struct timeval transmit;
+  gettimeofday(&transmit, NULL);
+  putTime(payload + 20, transmit);
+  serialFrameSend(FRAME_TIME_REPLY, payload, sizeof(payload));
+
+  uint32_t serviceUs = (uint32_t)((transmit.tv_sec - received.tv_sec) * 1000000L +
+                                  (transmit.tv_usec - received.tv_usec));
+  stats.lastServiceUs = serviceUs;
+  stats.sumServiceUs += serviceUs;
+  if (serviceUs > stats.maxServiceUs) {
+    stats.maxServiceUs = serviceUs;
+  }
+}
+
+// Zdarzenie odbioru USB CDC (zadanie zdarzeń USB) - tylko budzi zadanie
+static void onReceive(void *, esp_event_base_t, int32_t, void *) {
+  xTaskNotifyGive(task);
+}
+
+static void timeLinkTaskMain(void *) {
+  while (true) {
+    ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+    while (Serial.available() > 0) {
+      int c = Serial.read();
+      if (c < 0 || !reader.push((uint8_t)c) || reader.type() != FRAME_TIME_POLL) {
+        continue;
+      }
+      if (reader.length() != TIME_LINK_POLL_SIZE) {
+        stats.badFrames++;
+        continue;
+      }
+      // Znacznik odbioru po całej ramce: przebudzenie mogło przyjść
+      // od wcześniejszej paczki, zanim zapytanie w ogóle dotarło
+      struct timeval received;
+      gettimeofday(&received, NULL);
+      stats.polls++;
+      reply(reader.payload(), received);
+    }
+    TimeLinkStats copy = stats;
+    copy.badFrames += reader.errors();
+    statsShared.write(copy);
+  }
+}
+
+void timeLinkBegin() {
+  if (!TIME_LINK_ENABLE) {
+    return;
+  }
+  TimeLinkQuality q = {};
+  quality.write(q);
+  xTaskCreate(timeLinkTaskMain, "timeLink", 2560, nullptr, TIME_LINK_TASK_PRIORITY, &task);
+  Serial.onEvent(ARDUINO_USB_CDC_RX_EVENT, onReceive);
+}
+
+TaskHandle_t timeLinkTask() {
+  return task;
+}
+
+TimeLinkStats timeLinkStats() {
+  TimeLinkStats copy;
+  statsShared.read(copy);
+  return copy;
+}
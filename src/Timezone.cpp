@@ -0,0 +1,26 @@
+#include "Timezone.h"
+
+// Indeks pierwszej zmiany późniejszej niż utc (wyszukiwanie binarne)
+static int upperBound(int64_t utc) {
+  int lo = 0;
+  int hi = Timezone::size;
+  while (lo < hi) {
+    int mid = (lo + hi) / 2;
+    if (Timezone::transitions[mid].utc <= utc) {
+      lo = mid + 1;
+    } else {
+      hi = mid;
+    }
+  }
+  return lo;
+}
+
+int32_t tzOffset(time_t utc) {
+  int i = upperBound((int64_t)utc);
+  return i == 0 ? TZ_STD_OFFSET : Timezone::transitions[i - 1].offset;
+}
+
+time_t tzNextTransition(time_t utc) {
+  int i = upperBound((int64_t)utc);
+  return i < Timezone::size ? (time_t)Timezone::transitions[i].utc : 0;
+}
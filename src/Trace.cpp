@@ -0,0 +1,171 @@
+#include "Trace.h"
+
+#include <atomic>
+#include "Seqlock.h"
+#include "SerialFrame.h"
+
+// Najwięcej zdarzeń w jednej ramce i najrzadsza wysyłka
+static const uint32_t FRAME_MAX_EVENTS = 32;
+static const uint32_t EVENTS_INTERVAL_MS = 1000;
+static const uint32_t HISTOGRAMS_INTERVAL_MS = 60000;
+
+static_assert(FRAME_MAX_EVENTS * sizeof(TraceRecord) <= SERIAL_FRAME_MAX_PAYLOAD, "ramka zdarzeń");
+static_assert(2 + 2 * 4 * (TRACE_HIST_BUCKETS + 1) <= SERIAL_FRAME_MAX_PAYLOAD, "ramka histogramów");
+
+// Miejsce w pierścieniu: seq = 2 * (numer zapisu + 1), nieparzysty - zapis
+// w toku, 0 - puste. Po zawinięciu pierścienia dwa zadania mogą trafić w to
+// samo miejsce; drugie, zastając zapis w toku, gubi swoje zdarzenie.
+struct TraceSlot {
+  std::atomic<uint32_t> seq;
+  TraceRecord record;
+};
+
+static TraceSlot ring[TRACE_RING_SIZE];
+static std::atomic<uint32_t> head(0);   // liczba zarezerwowanych zapisów
+static uint32_t tail = 0;               // następny do wysłania (tylko pętla)
+
+static TraceStats stats = {};              // liczniki pętli (bez histogramów)
+static TraceHistogram loopPeriod = {};       // pisze tylko pętla
+static TraceHistogram displayLag = {};       // pisze tylko zadanie ekranu
+static Seqlock<TraceHistogram> loopPeriodShared;
+static Seqlock<TraceHistogram> displayLagShared;
+static uint32_t lastEventsExport = 0;
+static uint32_t lastHistogramsExport = 0;
+
+void TraceHistogram::add(uint32_t us) {
+  uint8_t bucket = us == 0 ? 0 : (uint8_t)(32 - __builtin_clz(us));
+  count[bucket < TRACE_HIST_BUCKETS ? bucket : TRACE_HIST_BUCKETS - 1]++;
+  if (us > maxUs) {
+    maxUs = us;
+  }
+  total++;
+}
+
+uint32_t TraceHistogram::percentile(uint8_t p) const {
+  uint32_t target = (uint32_t)(((uint64_t)total * p + 99) / 100);
+  uint32_t sum = 0;
+  for (uint8_t b = 0; b < TRACE_HIST_BUCKETS - 1; b++) {
+    sum += count[b];
+    if (sum >= target) {
+      return b == 0 ? 0 : (((uint32_t)1 << b) < maxUs ? (uint32_t)1 << b : maxUs);
+    }
+  }
+  return maxUs;
+}
+
+#if TRACE_ENABLE
+
+static uint32_t lastLoopUs = 0;
+
+void traceRecord(TraceEvent event, uint32_t startUs, uint16_t arg) {
+  uint32_t nowUs = (uint32_t)esp_timer_get_time();
+  uint32_t index = head.fetch_add(1, std::memory_order_relaxed);
+  TraceSlot &slot = ring[index & (TRACE_RING_SIZE - 1)];
+
+  // Kolejność jak w Seqlock: znacznik nieparzysty, bariera, dane, zapis z release
+  uint32_t seq = slot.seq.load(std::memory_order_relaxed);
+  if ((seq & 1) == 0 && slot.seq.compare_exchange_strong(seq, seq | 1, std::memory_order_relaxed)) {
+    std::atomic_thread_fence(std::memory_order_release);
+    slot.record.startUs = startUs;
+    slot.record.durationUs = nowUs - startUs;
+    slot.record.arg = arg;
+    slot.record.event = event;
+    slot.record.reserved = 0;
+    slot.seq.store((index + 1) << 1, std::memory_order_release);
+  }
+
+  if (event == TRACE_LOOP) {
+    if (lastLoopUs != 0) {
+      loopPeriod.add(startUs - lastLoopUs);
+      loopPeriodShared.write(loopPeriod);
+    }
+    lastLoopUs = startUs;
+  }
+}
+
+void traceDisplayLag(uint32_t lagUs) {
+  displayLag.add(lagUs);
+  displayLagShared.write(displayLag);
+}
+
+#endif
+
+// Kopiuje zapis `index`, jeśli nie został w międzyczasie nadpisany
+static bool readSlot(uint32_t index, TraceRecord &record) {
+  const TraceSlot &slot = ring[index & (TRACE_RING_SIZE - 1)];
+  uint32_t written = (index + 1) << 1;
+  if (slot.seq.load(std::memory_order_acquire) != written) {
+    return false;
+  }
+  record = slot.record;
+  std::atomic_thread_fence(std::memory_order_acquire);
+  return slot.seq.load(std::memory_order_relaxed) == written;
+}
+
+static void exportEvents() {
+  uint32_t end = head.load(std::memory_order_acquire);
+  if (end - tail > TRACE_RING_SIZE) {
+    stats.overwritten += end - tail - TRACE_RING_SIZE;
+    tail = end - TRACE_RING_SIZE;
+  }
+
+  TraceRecord records[FRAME_MAX_EVENTS];
+  while (tail != end) {
+    uint32_t n = 0;
+    while (tail != end && n < FRAME_MAX_EVENTS) {
+      if (readSlot(tail, records[n])) {
+        n++;
+      } else {
+        stats.overwritten++;   // nadpisany albo zapis w toku
+      }
+      tail++;
+    }
+    if (n > 0) {
+      serialFrameSend(FRAME_TRACE_EVENTS, reinterpret_cast<const uint8_t *>(records), (uint16_t)(n * sizeof(TraceRecord)));
+    }
+  }
+}
+
+// Dane: liczba histogramów, liczba kubełków, potem dla każdego max i kubełki
+static void exportHistograms() {
+  TraceHistogram loop;
+  TraceHistogram display;
+  loopPeriodShared.read(loop);
+  displayLagShared.read(display);
+  const TraceHistogram *histograms[] = {&loop, &display};
+  uint8_t payload[2 + 2 * 4 * (TRACE_HIST_BUCKETS + 1)];
+  size_t len = 0;
+  payload[len++] = 2;
+  payload[len++] = TRACE_HIST_BUCKETS;
+  for (const TraceHistogram *histogram : histograms) {
+    memcpy(payload + len, &histogram->maxUs, 4);
+    len += 4;
+    memcpy(payload + len, histogram->count, sizeof(histogram->count));
+    len += sizeof(histogram->count);
+  }
+  serialFrameSend(FRAME_TRACE_HISTOGRAMS, payload, (uint16_t)len);
+}
+
+void traceExport() {
+  if (!TRACE_STREAM || !TRACE_ENABLE) {
+    return;
+  }
+  uint32_t now = millis();
+  bool full = head.load(std::memory_order_relaxed) - tail >= TRACE_RING_SIZE / 2;
+  if (full || (uint32_t)(now - lastEventsExport) >= EVENTS_INTERVAL_MS) {
+    lastEventsExport = now;
+    exportEvents();
+  }
+  if ((uint32_t)(now - lastHistogramsExport) >= HISTOGRAMS_INTERVAL_MS) {
+    lastHistogramsExport = now;
+    exportHistograms();
+  }
+}
+
+TraceStats traceStats() {
+  TraceStats copy = stats;
+  loopPeriodShared.read(copy.loopPeriod);
+  displayLagShared.read(copy.displayLag);
+  copy.events = head.load(std::memory_order_relaxed);
+  return copy;
+}
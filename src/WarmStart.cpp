@@ -0,0 +1,133 @@
+#include "WarmStart.h"
+
+#include <Preferences.h>
+#include <esp_attr.h>
+#include <esp_system.h>
+#include <esp_timer.h>
+#include <sys/time.h>
+#include "Holdover.h"
+
+static const uint32_t WARM_MAGIC = 0x5a474753;   // "ZGGS"
+
+// Minimalna zmiana dryftu zapisywana do NVS (oszczędzanie flash)
+static const float NVS_PPM_STEP = 0.05f;
+
+// Po wyłączeniu zasilania temperatura i kwarc mogły się zmienić
+static const float COLD_PPM_ERROR_MIN = 1.0f;
+
+struct WarmData {
+  uint32_t magic;
+  int64_t savedUtc;         // zegar systemowy przy zapisie
+  HoldoverState holdover;
+  uint8_t satellites;
+  bool fix;
+  bool clockValid;
+  uint32_t crc;
+};
+
+static RTC_NOINIT_ATTR WarmData warm;
+
+static Preferences nvs;
+static float nvsPpm = NAN;
+static bool hadFix = false;
+static int64_t lastSaveUs = 0;
+static const char *resumeKind = "zimny";
+
+static int64_t bootUs[BOOT_STAGES];
+static bool bootDone[BOOT_STAGES];
+
+// FNV-1a po wszystkich polach przed crc
+static uint32_t checksum(const WarmData &data) {
+  const uint8_t *bytes = reinterpret_cast<const uint8_t *>(&data);
+  uint32_t hash = 2166136261UL;
+  for (size_t i = 0; i < offsetof(WarmData, crc); i++) {
+    hash = (hash ^ bytes[i]) * 16777619UL;
+  }
+  return hash;
+}
+
+static bool softReset() {
+  switch (esp_reset_reason()) {
+    case ESP_RST_SW:
+    case ESP_RST_PANIC:
+    case ESP_RST_INT_WDT:
+    case ESP_RST_TASK_WDT:
+    case ESP_RST_WDT:
+      return true;
+    default:
+      return false;   // zasilanie, brownout - pamięć RTC niepewna
+  }
+}
+
+bool warmStartBegin() {
+  nvs.begin("zegar", false);
+  HoldoverState state = holdoverState();
+
+  bool rtcValid = softReset() && warm.magic == WARM_MAGIC && warm.crc == checksum(warm);
+  if (rtcValid) {
+    state = warm.holdover;
+    hadFix = warm.fix;
+  } else if (nvs.isKey("ppm")) {
+    nvsPpm = nvs.getFloat("ppm");
+    state.ppm = nvsPpm;
+    state.ppmError = fmaxf(nvs.getFloat("ppmErr", HOLDOVER_INITIAL_PPM_ERROR), COLD_PPM_ERROR_MIN);
+    state.ppmValid = true;
+    resumeKind = "zimny, dryft z NVS";
+  }
+
+  // Zegar systemowy musi płynnie kontynuować zapisany czas
+  bool clockValid = false;
+  if (rtcValid && warm.clockValid) {
+    struct timeval now;
+    gettimeofday(&now, NULL);
+    clockValid = now.tv_sec >= warm.savedUtc && now.tv_sec - warm.savedUtc <= WARM_START_MAX_GAP_S;
+    resumeKind = clockValid ? "cieply" : "cieply, zegar niewazny";
+  }
+  holdoverResume(state, clockValid);
+  return clockValid;
+}
+
+bool warmStartHadFix() {
+  return hadFix;
+}
+
+void warmStartSave(bool clockValid, uint8_t satellites, bool fix) {
+  int64_t nowUs = esp_timer_get_time();
+  if (lastSaveUs != 0 && nowUs - lastSaveUs < 1000000) {
+    return;
+  }
+  lastSaveUs = nowUs;
+
+  struct timeval now;
+  gettimeofday(&now, NULL);
+  warm.magic = WARM_MAGIC;
+  warm.savedUtc = now.tv_sec;
+  warm.holdover = holdoverState();
+  warm.satellites = satellites;
+  warm.fix = fix;
+  warm.clockValid = clockValid;
+  warm.crc = checksum(warm);
+
+  // Dryft do NVS tylko po zauważalnej zmianie
+  if (warm.holdover.ppmValid && !(fabsf(warm.holdover.ppm - nvsPpm) < NVS_PPM_STEP)) {
+    nvs.putFloat("ppm", warm.holdover.ppm);
+    nvs.putFloat("ppmErr", warm.holdover.ppmError);
+    nvsPpm = warm.holdover.ppm;
+  }
+}
+
+void bootMark(BootStage stage) {
+  if (stage == BOOT_SETUP) {
+    memset(bootDone, 0, sizeof(bootDone));   // nowy start
+  } else if (bootDone[stage]) {
+    return;
+  }
+  bootDone[stage] = true;
+  bootUs[stage] = esp_timer_get_time();
+  if (stage != BOOT_SCREEN) {
+    return;
+  }
+  Serial.printf("START (%s): setup=%lums lcd=%lums zegar=%lums ekran=%lums\n", resumeKind,
+                (unsigned long)(bootUs[BOOT_SETUP] / 1000), (unsigned long)(bootUs[BOOT_LCD] / 1000),
+                (unsigned long)(bootUs[BOOT_CLOCK] / 1000), (unsigned long)(bootUs[BOOT_SCREEN] / 1000));
+}
@@ -1,22 +1,76 @@
 #include <Arduino.h>
-#include <wire.h>
-#include <LiquidCrystal_I2C.h>
-#include <TinyGPS++.h>
+#include <TimeLib.h>
+#include <Wire.h>
 #include <time.h>
+#include <atomic>
+#include "GnssFix.h"
+#include "GpsConfig.h"
+#include "GpsSync.h"
+#include "GpsTime.h"
+#include "GpsUart.h"
+#include "Health.h"
+#include "Hd44780.h"
+#include "Holdover.h"
+#include "LcdBuffer.h"
+#include "LocalClock.h"
+#include "NmeaParser.h"
+#include "NtpServer.h"
+#include "Power.h"
+#include "ScreenFormat.h"
+#include "Seqlock.h"
+#include "TimeLink.h"
+#include "Timezone.h"
+#include "Trace.h"
+#include "WarmStart.h"
 
 // Konfiguracja LCD
-LiquidCrystal_I2C lcd(0x27, 16, 2);
+Hd44780 lcd(0x27, 16, 2);
+LcdBuffer screen(lcd);
 
 // Konfiguracja GPS
-TinyGPSPlus gps;
+NmeaParser gps;
 #define RX_PIN 18
 #define TX_PIN 17
-HardwareSerial gpsSerial(1);
+GpsUart gpsUart(UART_NUM_1);
+GpsConfig gpsConfig(gpsUart);
 
-// Zmienne do synchronizacji czasu
+// Zadania: GNSS (parser) > zegar > ekran (I2C) > loop (raporty, sen).
+// Wolna transmisja I2C nigdy nie opóźnia parsowania ani ustawiania zegara.
+const UBaseType_t GNSS_TASK_PRIORITY = configMAX_PRIORITIES - 3;   // pod odbiorem UART
+const UBaseType_t CLOCK_TASK_PRIORITY = configMAX_PRIORITIES - 4;
+const UBaseType_t DISPLAY_TASK_PRIORITY = 2;                        // nad loop() (1)
+TaskHandle_t gnssTaskHandle = nullptr;
+TaskHandle_t clockTaskHandle = nullptr;
+TaskHandle_t displayTaskHandle = nullptr;
+
+// Migawka odbiornika; pisze tylko zadanie GNSS
+Seqlock<GnssFix> gnssFix;
+
+// Co ile zadanie GNSS sprawdza limity konfiguracji odbiornika
+const TickType_t GNSS_POLL_TICKS = pdMS_TO_TICKS(100);
+
+// Najdłuższy sen zadania zegara (holdoverTick, limit synchronizacji)
+const TickType_t CLOCK_TICKS = pdMS_TO_TICKS(1000);
+
+// Powiadomienia zadania ekranu
+const uint32_t DISPLAY_CLOCK_SET = 1 << 0;   // zegar ustawiony z GPS
+
+// Raport liczników odbioru NMEA i transferu LCD na USB
+const uint32_t STATS_INTERVAL = 60000UL;
+uint32_t lastStatsReport = 0;
+
+// Zmienne do synchronizacji czasu (interwał dobiera Holdover)
 uint32_t lastSyncTime = 0;
-const uint32_t SYNC_INTERVAL = 3600000UL;
-bool gpsTimeValid = false;
+std::atomic<bool> gpsTimeValid(false);
+
+// Ekran startowy tylko po zimnym starcie; nie blokuje zadań
+const uint32_t SPLASH_MS = 1000UL;
+uint32_t splashUntil = 0;
+bool splashShown = false;
+
+// Rozłożony czas lokalny, przeliczany od zera tylko po synchronizacji
+LocalClock localClock;
+time_t shownSecond = 0;   // sekunda ostatnio wysłana na LCD (UTC)
 
 // Konfiguracja podświetlenia LCD
 const int BACKLIGHT_PIN = 10;           // PWM capable pin
@@ -26,188 +80,251 @@ const int NIGHT_HOUR_START = 21;        // Godzina rozpoczęcia przyciemnienia
 const int NIGHT_HOUR_END = 6;           // Godzina zakończenia przyciemnienia
 bool isBacklightDimmed = false;
 int currentHour = 0;
-byte customCharS[8] = 
-  {B00010,B01111,B10000,B01110,B00001,B00001,B11110,B00000}; // Ś
-byte customChara[8] =
-  {B00000,B01110,B00001,B01111,B10001,B01111,B00010,B00001}; // ą 
-
-// Tablica skrótów nazw dni tygodnia
-const char* dniTygodnia[] = {"Nie", "Pon", "Wto", "\5ro", "Czw", "Pi\1", "Sob"};
+// Nazwy dni i polskie litery w CGRAM z lokalizacji Time-master
+// (TIME_LOCALE=TimeLocalePl w platformio.ini)
 
 // Minimalna liczba satelitów wymagana do uznania fiksa za dobry
 const int MIN_SATELLITES = 3;
 
-bool waitForGPSSync() {
-  lcd.clear();
-  lcd.setCursor(0, 0);
-  lcd.print("Czekam na GPS...");
-  lcd.setCursor(0, 1);
-  lcd.print("Sat: 0  Fix: NIE");
+void setTimeFromGPS(const GnssFix &fix, GpsSyncTier tier);
+GpsSync gpsSync(setTimeFromGPS);
+const uint32_t SYNC_TIMEOUT = 10000UL;
+
+// Przekazuje całe zdanie do parsera; true, jeśli było poprawne
+bool encodeSentence(const NmeaSentence &sentence) {
+  bool valid = gps.encode(sentence.data, sentence.len);
+  gpsUart.parsed(sentence);
+  return valid;
+}
+
+// Ustawia zegar (UTC) z czasu GPS, uwzględniając moment odebrania paczki.
+// Czas lokalny liczy LocalClock według tabeli strefy czasowej (zadanie ekranu).
+void setTimeFromGPS(const GnssFix &fix, GpsSyncTier tier) {
+  uint32_t traceUs = traceStart();
+  int64_t days = daysFromCivil(fix.year, fix.month, fix.day);
+  time_t t = (time_t)(days * 86400 + fix.hour * 3600L + fix.minute * 60L + fix.second);
+  gpsSetTime(t, fix.centisecond * 10000UL, fix.burstStartUs, tier == TIER_PROVISIONAL);
+  gpsTimeValid = true;
+  lastSyncTime = millis();
+  bootMark(BOOT_CLOCK);
+  traceRecord(TRACE_SYNC, traceUs);
+  xTaskNotify(displayTaskHandle, DISPLAY_CLOCK_SET, eSetBits);
+}
+
+// Parsuje zdanie, prowadzi konfigurację odbiornika i uzupełnia migawkę
+void processSentence(const NmeaSentence &sentence, GnssFix &fix) {
+  bool valid = encodeSentence(sentence);
+  gpsConfig.step(sentence, valid);
+  fix.passedChecksum = gps.passedChecksum();
+  fix.failedChecksum = gps.failedChecksum();
+  if (!valid) {
+    return;
+  }
+
+  // Świeży czas z datą z bieżącej paczki (odczyt kasuje flagi isUpdated())
+  if (gps.time.isUpdated() && gps.date.isUpdated() && gps.time.isValid() && gps.date.isValid()) {
+    fix.year = gps.date.year();
+    fix.month = gps.date.month();
+    fix.day = gps.date.day();
+    fix.hour = gps.time.hour();
+    fix.minute = gps.time.minute();
+    fix.second = gps.time.second();
+    fix.centisecond = gps.time.centisecond();
+    fix.burstStartUs = sentence.burstStartUs;
+    fix.timeSequence++;
+  }
+  fix.satellitesValid = gps.satellites.isValid();
+  fix.satellites = (uint8_t)gps.satellites.value();
+  fix.locationValid = gps.location.isValid();
+}
 
-  uint32_t startTime = millis();
-  int dotCount = 0;
-  uint32_t lastDotUpdate = 0;
-  uint32_t lastInfoUpdate = 0;
-  bool hasFix = false;
+// Odbiór: parsuje paczki zdań i publikuje migawkę dla zegara i ekranu
+void gnssTask(void *) {
+  GnssFix fix = {};
+  while (true) {
+    NmeaSentence sentence;
+    uint32_t traceUs = traceStart();
+    bool received = gpsUart.read(sentence, GNSS_POLL_TICKS);
+    traceRecord(TRACE_GPS_WAIT, traceUs);
+    if (received) {
+      traceUs = traceStart();
+      uint16_t count = 0;
+      do {
+        processSentence(sentence, fix);
+        count++;
+      } while (gpsUart.read(sentence));
+      gnssFix.write(fix);
+      traceRecord(TRACE_GPS_BATCH, traceUs, count);
+      xTaskNotifyGive(clockTaskHandle);
+    }
+    gpsConfig.poll();
+  }
+}
 
+// Zegar: synchronizacja z migawki, korekta dryftu, zapis stanu do RTC
+void clockTask(void *) {
+  GnssFix fix;
   while (true) {
-    // Animacja kropek
-    if (millis() - lastDotUpdate > 500) {
-      lastDotUpdate = millis();
-      lcd.setCursor(14, 0);
-      for (int i = 0; i < dotCount; i++) {
-        lcd.print(".");
-      }
-      for (int i = dotCount; i < 2; i++) {
-        lcd.print(" ");
-      }
-      dotCount = (dotCount + 1) % 3;
+    ulTaskNotifyTake(pdTRUE, CLOCK_TICKS);
+    gnssFix.read(fix);
+
+    // Okresowa resynchronizacja w tle - zegar chodzi dalej
+    if (gpsTimeValid && !gpsSync.busy() && (uint32_t)(millis() - lastSyncTime) >= holdoverInterval()) {
+      gpsSync.start(SYNC_TIMEOUT, 0, false);
+      lastSyncTime = millis();
     }
-    
-    // Aktualizacja informacji o satelitach i fiksie
-    if (millis() - lastInfoUpdate > 1000) {
-      lastInfoUpdate = millis();
-      
-      // Aktualizacja liczby satelitów
-      lcd.setCursor(5, 1);
-      lcd.print("  ");
-      lcd.setCursor(5, 1);
-      if (gps.satellites.isValid()) {
-        lcd.print(gps.satellites.value());
-      } else {
-        lcd.print("0");
-      }
-      
-      // Aktualizacja statusu fiksa
-      lcd.setCursor(13, 1);
-      if (gps.location.isValid() && gps.satellites.isValid() && gps.satellites.value() >= MIN_SATELLITES) {
-        lcd.print("TAK");
-        hasFix = true;
-      } else {
-        lcd.print("NIE");
-        hasFix = false;
-      }
+    gpsSync.step(fix);
+    gpsSync.poll();
+    holdoverTick();
+    HoldoverStats holdover = holdoverStats();
+    if (NTP_SERVER_ENABLE) {
+      ntpServerUpdate(gpsSync.tier(), holdover);
     }
-    
-    while (gpsSerial.available() > 0) {
-      if (gps.encode(gpsSerial.read())) {
-        if (gps.time.isValid() && gps.date.isValid() && gps.location.isValid() && 
-            gps.satellites.isValid() && gps.satellites.value() >= MIN_SATELLITES) {
-          
-          // Mamy czas, datę i lokalizację oraz wystarczającą liczbę satelitów
-          struct tm tm;
-          tm.tm_year = gps.date.year() - 1900;
-          tm.tm_mon = gps.date.month() - 1;
-          tm.tm_mday = gps.date.day();
-          currentHour = gps.time.hour() + 2;
-          tm.tm_hour = currentHour;
-          tm.tm_min = gps.time.minute();
-          tm.tm_sec = gps.time.second();
-          tm.tm_isdst = -1;
-
-          time_t t = mktime(&tm);
-          struct timeval tv = { t, 0 };
-          settimeofday(&tv, NULL);
-
-          lcd.clear();
-          lcd.setCursor(0, 0);
-          lcd.print("GPS Sync OK!");
-          lcd.setCursor(0, 1);
-          lcd.print("SAT: ");
-          lcd.print(gps.satellites.value());
-          lcd.print(" FIX: TAK");
-          delay(2000);
-          return true;
-        }
-      }
+    if (TIME_LINK_ENABLE) {
+      timeLinkUpdate(gpsTimeValid, gpsSync.tier(), gpsSync.status(), fix, holdover);
     }
-    
-    // Pokaż, że nadal czekamy, ale nie przerywaj
-    delay(10);
+    warmStartSave(gpsTimeValid, fix.satellitesValid ? fix.satellites : 0, fix.locationValid);
   }
 }
 
-void syncTimeWithGPS() {
-  // Funkcja przywrócona do oryginalnej formy
-  lcd.setCursor(0, 0);
-  lcd.print("Sync GPS...     ");
-
-  uint32_t startTime = millis();
-  while ((uint32_t)(millis() - startTime) < 10000UL) {
-    while (gpsSerial.available() > 0) {
-      if (gps.encode(gpsSerial.read())) {
-        if (gps.time.isValid() && gps.date.isValid()) {
-          struct tm tm;
-          tm.tm_year = gps.date.year() - 1900;
-          tm.tm_mon = gps.date.month() - 1;
-          tm.tm_mday = gps.date.day();
-          currentHour = gps.time.hour() + 2;
-          tm.tm_hour = currentHour;
-          tm.tm_min = gps.time.minute();
-          tm.tm_sec = gps.time.second();
-          tm.tm_isdst = -1;
-
-          time_t t = mktime(&tm);
-          struct timeval tv = { t, 0 };
-          settimeofday(&tv, NULL);
-
-          gpsTimeValid = true;
-          lcd.setCursor(0, 0);
-          lcd.print("GPS Sync OK!    ");
-          delay(1000);
-          return;
-        }
-      }
-    }
-    delay(10);
+void reportStats() {
+  GpsUartStats stats = gpsUart.stats();
+  uint32_t avgLatency = stats.sentences ? (uint32_t)(stats.sumLatencyUs / stats.sentences) : 0;
+  Serial.printf("GPS: %lu bod (stan %d) bajty=%lu zdania=%lu utracone=%lu przepelnienia=%lu opoznienie[us] ost=%lu sr=%lu max=%lu\n",
+                (unsigned long)gpsUart.baud(), (int)gpsConfig.status(),
+                (unsigned long)stats.bytes, (unsigned long)stats.sentences, (unsigned long)stats.droppedBytes,
+                (unsigned long)stats.overflowEvents, (unsigned long)stats.lastLatencyUs,
+                (unsigned long)avgLatency, (unsigned long)stats.maxLatencyUs);
+
+  LcdStats lcdStats = screen.stats();
+  Serial.printf("LCD: odswiezenia=%lu znaki=%lu komendy=%lu i2c=%lu/%luB magistrala[us] ost=%lu max=%lu sr=%lu\n",
+                (unsigned long)lcdStats.flushes, (unsigned long)lcdStats.chars,
+                (unsigned long)lcdStats.commands, (unsigned long)lcdStats.bus.transactions,
+                (unsigned long)lcdStats.bus.bytes, (unsigned long)lcdStats.lastBusUs,
+                (unsigned long)lcdStats.maxBusUs,
+                (unsigned long)(lcdStats.flushes ? lcdStats.sumBusUs / lcdStats.flushes : 0));
+
+  HoldoverStats holdover = holdoverStats();
+  Serial.printf("ZEGAR: dryft=%+.2fppm (+-%.2f%s) przesuniecie=%ldus skoki=%lu interwal=%lus od_sync=%lus blad_szac=%luus\n",
+                holdover.ppm, holdover.ppmError, holdover.ppmValid ? "" : " brak pomiaru",
+                (long)holdover.lastOffsetUs, (unsigned long)holdover.steps,
+                (unsigned long)(holdover.intervalMs / 1000), (unsigned long)(holdover.sinceSyncMs / 1000),
+                (unsigned long)holdover.estimatedErrorUs);
+
+  if (NTP_SERVER_ENABLE) {
+    NtpServerStats ntp = ntpServerStats();
+    Serial.printf("NTP: %s stratum=%u zapytania=%lu odpowiedzi=%lu odrzucone=%lu obsluga[us] ost=%lu sr=%lu max=%lu\n",
+                  ntp.connected ? "WiFi" : "brak sieci", (unsigned)ntp.stratum,
+                  (unsigned long)ntp.requests, (unsigned long)ntp.replies, (unsigned long)ntp.ignored,
+                  (unsigned long)ntp.lastServiceUs,
+                  (unsigned long)(ntp.replies ? ntp.sumServiceUs / ntp.replies : 0),
+                  (unsigned long)ntp.maxServiceUs);
+  }
+
+  if (TIME_LINK_ENABLE) {
+    TimeLinkStats link = timeLinkStats();
+    Serial.printf("USB: zapytania=%lu bledne=%lu obsluga[us] ost=%lu sr=%lu max=%lu\n",
+                  (unsigned long)link.polls, (unsigned long)link.badFrames,
+                  (unsigned long)link.lastServiceUs,
+                  (unsigned long)(link.polls ? link.sumServiceUs / link.polls : 0),
+                  (unsigned long)link.maxServiceUs);
+  }
+
+  HealthStats health = healthStats();
+  Serial.printf("STAN: sterta=%lu min=%lu blok=%lu przepelnienia=%lu nmea ok=%lu bledy=%lu od_ok=%lus reset=%u (%s) stos[B]",
+                (unsigned long)health.freeHeap, (unsigned long)health.minFreeHeap,
+                (unsigned long)health.largestBlock, (unsigned long)health.uartOverflows,
+                (unsigned long)health.checksumPassed, (unsigned long)health.checksumFailed,
+                (unsigned long)(health.sinceValidMs / 1000), (unsigned)health.resetReason,
+                healthFaultName(health.lastFault));
+  for (uint8_t i = 0; i < health.tasks; i++) {
+    Serial.printf(" %s=%lu", health.stacks[i].name, (unsigned long)health.stacks[i].freeBytes);
   }
+  Serial.println();
+
+  TraceStats trace = traceStats();
+  Serial.printf("PETLA[us]: okres p50=%lu p99=%lu max=%lu ekran-sekunda p50=%lu p99=%lu max=%lu zdarzenia=%lu nadpisane=%lu\n",
+                (unsigned long)trace.loopPeriod.percentile(50), (unsigned long)trace.loopPeriod.percentile(99),
+                (unsigned long)trace.loopPeriod.maxUs, (unsigned long)trace.displayLag.percentile(50),
+                (unsigned long)trace.displayLag.percentile(99), (unsigned long)trace.displayLag.maxUs,
+                (unsigned long)trace.events, (unsigned long)trace.overwritten);
+
+  PowerStats power = powerStats();
+  Serial.printf("CPU: %lu MHz aktywny=%.1f%% sen=%.1f%% (%lu razy)\n",
+                (unsigned long)power.cpuMhz,
+                100.0 * (double)(power.totalUs - power.idleUs) / (double)power.totalUs,
+                100.0 * (double)power.sleepUs / (double)power.totalUs,
+                (unsigned long)power.sleeps);
+}
+
+// Restart po przekroczeniu progu kontroli stanu; zegar wznowi WarmStart.
+// Ekran należy do zadania ekranu, więc bez komunikatu na LCD.
+void healthRestart(HealthFault fault) {
+  Serial.printf("STAN: restart - %s\n", healthFaultName(fault));
+  Serial.flush();
+  healthRecordRestart(fault);
+  ESP.restart();
+}
+
+// Ekran oczekiwania na pierwszą synchronizację
+void displayWaitingOnLCD(const GnssFix &fix) {
+  char *row = screen.row(0, WaitRow0::text);
+
+  // Animacja kropek
+  int dotCount = (millis() / 500) % 3;
+  row[WaitRow0::DOTS] = dotCount > 0 ? '.' : ' ';
+  row[WaitRow0::DOTS + 1] = dotCount > 1 ? '.' : ' ';
 
-  lcd.setCursor(0, 0);
-  lcd.print("GPS Sync FAIL!  ");
-  delay(1000);
+  // Liczba satelitów i status fiksa
+  row = screen.row(1, WaitRow1::text);
+  uint8_t sats = fix.satellitesValid ? (fix.satellites > 99 ? 99 : fix.satellites) : 0;
+  if (sats < 10) {
+    row[WaitRow1::SATELLITES] = (char)('0' + sats);
+    row[WaitRow1::SATELLITES + 1] = ' ';
+  } else {
+    fmt2(row + WaitRow1::SATELLITES, sats);
+  }
+  bool fixOk = fix.locationValid && fix.satellitesValid && fix.satellites >= MIN_SATELLITES;
+  memcpy(row + WaitRow1::FIX, fixOk ? "TAK" : "NIE", 3);
 }
 
-void displayTimeOnLCD() {
-  time_t now = time(nullptr);
-  struct tm* p_tm = localtime(&now);
-  currentHour = p_tm->tm_hour;
-  
-  // Sprawdzenie czy jest godzina 5:00:00 - restart
-  if (p_tm->tm_hour == 5 && p_tm->tm_min == 0 && p_tm->tm_sec == 0) {
-    lcd.setCursor(0, 0);  // Dodatkowa informacja na LCD (opcjonalnie)
-    lcd.print("Restarting...   ");
-    delay(1000);  // Krótkie opóźnienie na wyświetlenie komunikatu
-    ESP.restart();  // Wykonaj restart ESP32
+// Znak statusu synchronizacji w wierszu czasu
+char syncStatusChar() {
+  if (gpsSync.tier() == TIER_PROVISIONAL) {
+    return '?';   // czas bez fiksa pozycji
   }
+  switch (gpsSync.status()) {
+    case SYNC_WAITING: return '*';
+    case SYNC_FAILED:  return '!';
+    default:           return ' ';
+  }
+}
 
-  char timeStringBuff[9];
-  strftime(timeStringBuff, sizeof(timeStringBuff), "%H:%M:%S", p_tm);
-  
-  lcd.setCursor(0, 0);
-  lcd.print(timeStringBuff);
-  
-  lcd.setCursor(9, 0);
-  lcd.print(" SAT:");
-  if (gps.satellites.isValid()) {
-    lcd.print(gps.satellites.value() < 10 ? "0" : "");
-    lcd.print(gps.satellites.value());
+void displayTimeOnLCD(const GnssFix &fix) {
+  const struct tm &t = localClock.fields();
+  currentHour = t.tm_hour;
+
+  char *row = screen.row(0, TimeRow::text);
+  fmt2(row + TimeRow::HOUR, (uint8_t)t.tm_hour);
+  fmt2(row + TimeRow::MINUTE, (uint8_t)t.tm_min);
+  fmt2(row + TimeRow::SECOND, (uint8_t)t.tm_sec);
+  row[TimeRow::STATUS] = syncStatusChar();
+  if (fix.satellitesValid) {
+    fmt2(row + TimeRow::SATELLITES, fix.satellites > 99 ? 99 : fix.satellites);
   } else {
-    lcd.print("--");
+    row[TimeRow::SATELLITES] = '-';
+    row[TimeRow::SATELLITES + 1] = '-';
   }
 }
 
 void displayDateOnLCD() {
-  time_t now = time(nullptr);
-  struct tm* p_tm = localtime(&now);
-  
-  char dateStringBuff[11];
-  strftime(dateStringBuff, sizeof(dateStringBuff), "%d.%m.%Y", p_tm);
-  
-  lcd.setCursor(0, 1);
-  lcd.print(" ");
-  lcd.print(dniTygodnia[p_tm->tm_wday]);
-  lcd.print(", ");
-  lcd.print(dateStringBuff);
+  const struct tm &t = localClock.fields();
+
+  char *row = screen.row(1, DateRow::text);
+  memcpy(row + DateRow::WEEKDAY, dayShortText((uint8_t)(t.tm_wday + 1)).text, 3);
+  fmt2(row + DateRow::DAY, (uint8_t)t.tm_mday);
+  fmt2(row + DateRow::MONTH, (uint8_t)(t.tm_mon + 1));
+  fmt4(row + DateRow::YEAR, (uint16_t)(t.tm_year + 1900));
 }
 
 void updateBacklight() {
@@ -223,9 +340,83 @@ void updateBacklight() {
   }
 }
 
+// Zapis na LCD; przy nowej sekundzie mierzy opóźnienie względem jej początku
+void flushScreen(time_t second) {
+  uint32_t traceUs = traceStart();
+  LcdStats before = screen.stats();
+  screen.flush();
+  traceRecord(TRACE_LCD_FLUSH, traceUs, (uint16_t)(screen.stats().chars - before.chars));
+
+  if (second != shownSecond) {
+    shownSecond = second;
+    struct timeval now;
+    gettimeofday(&now, NULL);
+    traceDisplayLag((uint32_t)((now.tv_sec - second) * 1000000L + now.tv_usec));
+  }
+}
+
+// Rysuje ekran z bieżącego czasu systemowego i migawki odbiornika
+void drawScreen(const GnssFix &fix) {
+  if (gpsTimeValid) {
+    time_t now = time(nullptr);
+    localClock.update(now);
+    uint32_t traceUs = traceStart();
+    displayTimeOnLCD(fix);
+    traceRecord(TRACE_TIME_LCD, traceUs);
+    traceUs = traceStart();
+    displayDateOnLCD();
+    traceRecord(TRACE_DATE_LCD, traceUs);
+    flushScreen(now);
+    bootMark(BOOT_SCREEN);
+    traceUs = traceStart();
+    updateBacklight();
+    traceRecord(TRACE_BACKLIGHT, traceUs);
+  } else if (!splashShown || (int32_t)(millis() - splashUntil) >= 0) {
+    if (splashShown) {
+      screen.clear();
+      splashShown = false;
+    }
+    displayWaitingOnLCD(fix);
+    screen.flush();
+  }
+}
+
+// Ticki do następnej zmiany ekranu: pełna sekunda zegara albo krok animacji
+TickType_t displayWaitTicks() {
+  uint32_t waitMs;
+  if (gpsTimeValid) {
+    struct timeval now;
+    gettimeofday(&now, NULL);
+    waitMs = (uint32_t)((1000000 - now.tv_usec + 999) / 1000);
+  } else {
+    waitMs = 500 - millis() % 500;
+  }
+  return pdMS_TO_TICKS(waitMs) > 0 ? pdMS_TO_TICKS(waitMs) : 1;
+}
+
+// Ekran: budzony na pełną sekundę i po ustawieniu zegara; jedyny
+// użytkownik LCD (I2C) po setup()
+void displayTask(void *) {
+  GnssFix fix;
+  uint32_t events = 0;
+  while (true) {
+    if (events & DISPLAY_CLOCK_SET) {
+      localClock.invalidate();
+    }
+    gnssFix.read(fix);
+    drawScreen(fix);
+    events = 0;
+    xTaskNotifyWait(0, UINT32_MAX, &events, displayWaitTicks());
+  }
+}
+
 void setup() {
+  bootMark(BOOT_SETUP);
   Serial.begin(115200);
-  gpsSerial.begin(9600, SERIAL_8N1, RX_PIN, TX_PIN);
+  gpsUart.begin(GPS_DEFAULT_BAUD, RX_PIN, TX_PIN);
+  gpsTimeBegin();
+  powerBegin();
+  healthBegin();
 
   // Inicjalizacja podświetlenia LCD
   pinMode(BACKLIGHT_PIN, OUTPUT);
@@ -235,34 +426,60 @@ void setup() {
   Wire.begin(8, 9);
   Wire.setClock(400000);
   lcd.init();
-  lcd.createChar(5, customCharS);
-  lcd.createChar(1, customChara);
+  timeLocaleCreateChars(lcd);
   lcd.backlight();
-  lcd.clear();
-  lcd.setCursor(0, 0);
-  lcd.print("RTC GPS Sync");
-  delay(1000);
-
-  // Czekamy na synchronizację z GPS przed kontynuowaniem
-  gpsTimeValid = waitForGPSSync();
-  lastSyncTime = millis();
-  
-  lcd.clear();
-}
+  screen.invalidate();
+  screen.clear();
+  bootMark(BOOT_LCD);
 
-void loop() {
-  if ((uint32_t)(millis() - lastSyncTime) >= SYNC_INTERVAL) {
-    syncTimeWithGPS();
+  gpsConfig.start();
+  gpsTimeValid = warmStartBegin();
+  if (gpsTimeValid) {
+    // Zegar przetrwał restart - od razu czas na ekranie, GPS go potwierdzi
+    bootMark(BOOT_CLOCK);
     lastSyncTime = millis();
+    gpsSync.start(warmStartHadFix() ? SYNC_TIMEOUT : 0, MIN_SATELLITES, false);
+  } else {
+    // Pierwsza synchronizacja: czas tymczasowy z kolejnych sekund, potem fiks;
+    // ekran oczekiwania rysuje zadanie ekranu
+    screen.setCursor(0, 0);
+    screen.print("RTC GPS Sync");
+    screen.flush();
+    splashShown = true;
+    splashUntil = millis() + SPLASH_MS;
+    gpsSync.start(0, MIN_SATELLITES, true);
   }
 
-  displayTimeOnLCD();
-  displayDateOnLCD();
-  updateBacklight();
+  ntpServerBegin();
+  timeLinkBegin();
+  xTaskCreate(displayTask, "display", 4096, nullptr, DISPLAY_TASK_PRIORITY, &displayTaskHandle);
+  xTaskCreate(clockTask, "clock", 4096, nullptr, CLOCK_TASK_PRIORITY, &clockTaskHandle);
+  xTaskCreate(gnssTask, "gnss", 4096, nullptr, GNSS_TASK_PRIORITY, &gnssTaskHandle);
 
-  while (gpsSerial.available() > 0) {
-    gps.encode(gpsSerial.read());
+  healthWatchTask(xTaskGetCurrentTaskHandle());
+  healthWatchTask(gpsUart.taskHandle());
+  healthWatchTask(gnssTaskHandle);
+  healthWatchTask(clockTaskHandle);
+  healthWatchTask(displayTaskHandle);
+  healthWatchTask(ntpServerTask());
+  healthWatchTask(timeLinkTask());
+}
+
+// Najniższy priorytet: działa, gdy pozostałe zadania czekają
+void loop() {
+  uint32_t loopUs = traceStart();
+  GnssFix fix;
+  gnssFix.read(fix);
+  HealthFault fault = healthCheck(gpsUart.stats(), fix);
+  if (fault != HEALTH_OK) {
+    healthRestart(fault);
   }
 
-  delay(20);
-}
\ No newline at end of file
+  if ((uint32_t)(millis() - lastStatsReport) >= STATS_INTERVAL) {
+    lastStatsReport = millis();
+    reportStats();
+  }
+  traceExport();
+  traceRecord(TRACE_LOOP, loopUs);
+  powerIdle(gpsUart, gpsTimeValid, displayTaskHandle);
+}
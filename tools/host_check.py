@@ -0,0 +1,118 @@
+#!/usr/bin/env python3
+"""Sprawdzenie firmware na hoście: scenariusze --replay i tryby --test-*.
+
+Każdy scenariusz z nmea_synth.py jest odtwarzany pod zegarem wirtualnym,
+a raport [sim] musi dać:
+  - pierwszy czas na LCD (ekran w ogóle pokazał godzinę),
+  - 0 złych sekund na LCD i 0 zbędnych zapisów LCD,
+  - oczekiwaną liczbę restartów (1 tylko w stall).
+Potem --test-gps-time, --test-nmea, --test-time, --test-timelib,
+--test-timezone (brak strefy w zoneinfo systemu to pominięcie, nie błąd)
+i --stress-time 4 1 (rozdarty odczyt zegara lub złe pola to błąd).
+
+Kod wyjścia 0, gdy wszystko się zgadza, inaczej 1.
+
+Użycie: tools/host_check.py [--program .pio/build/native/program]
+                            [--bench wyniki.csv]
+  --bench - dodatkowo --bench-suite, wynik CSV do pliku
+"""
+
+import argparse
+import os
+import re
+import subprocess
+import sys
+import tempfile
+
+sys.path.insert(0, os.path.dirname(os.path.abspath(__file__)))
+from nmea_synth import SCENARIOS  # noqa: E402
+
+# Restart z kontroli stanu jest w stall celowy
+EXPECTED_RESTARTS = {"stall": 1}
+
+TESTS = [
+    ["--test-gps-time"],
+    ["--test-nmea"],
+    ["--test-time"],
+    ["--test-timelib"],
+    ["--test-timezone"],
+    ["--stress-time", "4", "1"],
+]
+
+# --test-timezone: strefy nie ma w zoneinfo systemu
+EXIT_SKIPPED = 2
+
+
+def report_value(report, label):
+    match = re.search(r"^\[sim\] %s\s+(\S+)" % re.escape(label), report, re.M)
+    return match.group(1) if match else None
+
+
+def check_replay(program, name, workdir):
+    path = os.path.join(workdir, name + ".nmea")
+    with open(path, "w") as f:
+        f.write(SCENARIOS[name]())
+    run = subprocess.run([program, "--replay", path], stdout=subprocess.PIPE,
+                         stderr=subprocess.STDOUT)
+    report = run.stdout.decode("utf-8", "replace")
+    errors = []
+    if run.returncode != 0:
+        errors.append("kod wyjścia %d" % run.returncode)
+    first = report_value(report, "pierwszy czas na LCD")
+    if first is None or first == "-":
+        errors.append("brak czasu na LCD")
+    for label in ("zła sekunda na LCD", "zbędne zapisy LCD"):
+        value = report_value(report, label)
+        if value != "0":
+            errors.append("%s: %s" % (label, value or "brak w raporcie"))
+    restarts = report_value(report, "restartów")
+    expected = EXPECTED_RESTARTS.get(name, 0)
+    if restarts != str(expected):
+        errors.append("restartów %s, oczekiwano %d" % (restarts, expected))
+    return errors, report
+
+
+def main():
+    parser = argparse.ArgumentParser()
+    parser.add_argument("--program", default=".pio/build/native/program")
+    parser.add_argument("--bench", metavar="CSV")
+    args = parser.parse_args()
+
+    failed = False
+    with tempfile.TemporaryDirectory() as workdir:
+        for name in SCENARIOS:
+            errors, report = check_replay(args.program, name, workdir)
+            if errors:
+                failed = True
+                print("BŁĄD   replay %-9s %s" % (name, "; ".join(errors)))
+                sys.stdout.write("".join("  " + line + "\n" for line in report.splitlines()
+                                         if line.startswith("[sim]")))
+            else:
+                print("OK     replay %s" % name)
+
+    for test in TESTS:
+        run = subprocess.run([args.program] + test, stdout=subprocess.PIPE,
+                             stderr=subprocess.STDOUT)
+        if run.returncode == 0:
+            print("OK     %s" % " ".join(test))
+        elif test[0] == "--test-timezone" and run.returncode == EXIT_SKIPPED:
+            print("POMIN. %s (brak strefy w zoneinfo)" % " ".join(test))
+        else:
+            failed = True
+            print("BŁĄD   %s (kod wyjścia %d)" % (" ".join(test), run.returncode))
+            sys.stdout.write(run.stdout.decode("utf-8", "replace"))
+
+    if args.bench:
+        with open(args.bench, "w") as f:
+            run = subprocess.run([args.program, "--bench-suite"], stdout=f)
+        if run.returncode != 0:
+            failed = True
+            print("BŁĄD   --bench-suite (kod wyjścia %d)" % run.returncode)
+        else:
+            print("OK     --bench-suite -> %s" % args.bench)
+
+    sys.exit(1 if failed else 0)
+
+
+if __name__ == "__main__":
+    main()
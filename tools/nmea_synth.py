@@ -0,0 +1,88 @@
+#!/usr/bin/env python3
+"""Syntetyczne zapisy NMEA w stylu AT6558R dla symulatora (--replay).
+
+Scenariusze:
+  cold     - zimny start: puste zdania, potem czas bez fixu, potem fix
+  lostfix  - utrata fixu na 20 s i przerwa w odbiorze
+  lowsat   - liczba satelitów spada poniżej MIN_SATELLITES
+  midnight - północ czasu lokalnego
+  dst      - zmiana czasu na letni (ostatnia niedziela marca)
+  newyear  - Nowy Rok czasu lokalnego
+  restart  - godzina 05:00:00 czasu lokalnego (dawny codzienny restart)
+  stall    - po 20 s odbioru same błędne sumy kontrolne (restart z kontroli stanu)
+
+Użycie: tools/nmea_synth.py SCENARIUSZ > zapis.nmea
+"""
+
+import datetime
+import sys
+
+
+def sentence(body, corrupt=False):
+    checksum = 0xFF if corrupt else 0
+    for ch in body:
+        checksum ^= ord(ch)
+    return "$%s*%02X\r\n" % (body, checksum)
+
+
+def burst(t, fix=True, sats=8, has_time=True, corrupt=False):
+    """Jedna sekunda odbiornika: GGA, GSA, GSV, RMC, ZDA."""
+    hms = t.strftime("%H%M%S") + ".000" if has_time else ""
+    date = t.strftime("%d%m%y") if has_time else ""
+    pos = "5213.0000,N,02100.0000,E" if fix else ",,,"
+    out = [
+        sentence("GNGGA,%s,%s,%d,%02d,1.0,100.0,M,0.0,M,," % (hms, pos, 1 if fix else 0, sats)),
+        sentence("GNGSA,A,%d,01,02,12,14,,,,,,,,,1.8,1.0,1.5,1" % (3 if fix else 1)),
+        sentence("GPGSV,2,1,08,01,40,083,46,02,17,308,41,12,07,344,39,14,22,228,45,0"),
+        sentence("GNRMC,%s,%s,%s,0.0,0.0,%s,,,%s" % (hms, "A" if fix else "V", pos, date,
+                                                   "A" if fix else "N")),
+    ]
+    if has_time:
+        out.append(sentence("GNZDA,%s,%s,%s,%s,00,00" % (hms, t.strftime("%d"), t.strftime("%m"),
+                                                         t.strftime("%Y"))))
+    if corrupt:
+        out = [sentence(line[1:line.index("*")], corrupt=True) for line in out]
+    return "".join(out)
+
+
+def utc(*args):
+    return datetime.datetime(*args)
+
+
+def run(start, seconds, state=lambda i: {}):
+    out = []
+    for i in range(seconds):
+        kwargs = state(i)
+        if kwargs is None:
+            continue  # brak odbioru
+        out.append(burst(start + datetime.timedelta(seconds=i), **kwargs))
+    return "".join(out)
+
+
+SCENARIOS = {
+    "cold": lambda: run(utc(2026, 6, 1, 10, 0, 0), 90,
+                        lambda i: {"has_time": False, "fix": False, "sats": 0} if i < 30 else
+                                  {"fix": False, "sats": 2} if i < 60 else {"sats": 6}),
+    "lostfix": lambda: run(utc(2026, 6, 1, 10, 0, 0), 90,
+                           lambda i: None if 40 <= i < 50 else
+                                     {"fix": False, "sats": 1} if 30 <= i < 60 else {}),
+    "lowsat": lambda: run(utc(2026, 6, 1, 10, 0, 0), 60,
+                          lambda i: {"sats": 8 - min(i // 10, 6)}),
+    "midnight": lambda: run(utc(2026, 6, 1, 21, 59, 30), 60),
+    "dst": lambda: run(utc(2026, 3, 29, 0, 59, 30), 60),
+    "newyear": lambda: run(utc(2026, 12, 31, 22, 59, 30), 60),
+    "restart": lambda: run(utc(2026, 6, 1, 2, 59, 40), 40),
+    "stall": lambda: run(utc(2026, 6, 1, 10, 0, 0), 360,
+                         lambda i: {"corrupt": True} if 20 <= i < 340 else {}),
+}
+
+
+def main():
+    if len(sys.argv) != 2 or sys.argv[1] not in SCENARIOS:
+        sys.stderr.write(__doc__)
+        sys.exit(2)
+    sys.stdout.write(SCENARIOS[sys.argv[1]]())
+
+
+if __name__ == "__main__":
+    main()
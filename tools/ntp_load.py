@@ -0,0 +1,103 @@
+#!/usr/bin/env python3
+"""Klient obciążeniowy SNTP dla serwera z NtpServer.cpp (np. firmware na hoście).
+
+Wysyła zapytania NTPv4 (mode 3) z zadaną częstością i liczy przepustowość,
+czas odpowiedzi (RTT), czas obsługi po stronie serwera (t3 - t2) oraz
+przesunięcie zegara serwera względem klienta. Sprawdza też, czy odpowiedź
+pasuje do zapytania (originate == transmit klienta).
+
+Użycie: tools/ntp_load.py [--host 127.0.0.1] [--port 12300] [--rate 500]
+                          [--duration 10]
+  --rate 0 - bez limitu (następne zapytanie zaraz po odpowiedzi)
+"""
+
+import argparse
+import socket
+import struct
+import time
+
+NTP_UNIX_OFFSET = 2208988800
+
+
+def to_ntp(t):
+    seconds = int(t)
+    return seconds + NTP_UNIX_OFFSET, int((t - seconds) * 2 ** 32) & 0xFFFFFFFF
+
+
+def from_ntp(seconds, fraction):
+    return seconds - NTP_UNIX_OFFSET + fraction / 2 ** 32
+
+
+def percentile(values, p):
+    if not values:
+        return 0.0
+    ordered = sorted(values)
+    return ordered[min(len(ordered) - 1, int(len(ordered) * p / 100))]
+
+
+def main():
+    parser = argparse.ArgumentParser()
+    parser.add_argument("--host", default="127.0.0.1")
+    parser.add_argument("--port", type=int, default=12300)
+    parser.add_argument("--rate", type=float, default=500)
+    parser.add_argument("--duration", type=float, default=10)
+    args = parser.parse_args()
+
+    sock = socket.socket(socket.AF_INET, socket.SOCK_DGRAM)
+    sock.settimeout(0.5)
+    rtts, services, offsets = [], [], []
+    sent = lost = mismatched = 0
+    header = None
+    start = time.monotonic()
+    next_send = start
+    while time.monotonic() - start < args.duration:
+        if args.rate > 0:
+            delay = next_send - time.monotonic()
+            if delay > 0:
+                time.sleep(delay)
+            next_send += 1.0 / args.rate
+
+        t1 = time.time()
+        seconds, fraction = to_ntp(t1)
+        request = struct.pack("!B39xII", 0x23, seconds, fraction)  # LI 0, VN 4, mode 3
+        sock.sendto(request, (args.host, args.port))
+        sent += 1
+        try:
+            reply, _ = sock.recvfrom(512)
+        except socket.timeout:
+            lost += 1
+            continue
+        t4 = time.time()
+        if len(reply) < 48:
+            mismatched += 1
+            continue
+        fields = struct.unpack("!BBbb4xI4s8xIIIIII", reply[:48])
+        first, stratum, poll, precision, dispersion, ref_id = fields[:6]
+        originate = fields[6:8]
+        if originate != (seconds, fraction):
+            mismatched += 1
+            continue
+        t2 = from_ntp(*fields[8:10])
+        t3 = from_ntp(*fields[10:12])
+        rtts.append(t4 - t1 - (t3 - t2))
+        services.append(t3 - t2)
+        offsets.append(((t2 - t1) + (t3 - t4)) / 2)
+        header = (first >> 6, (first >> 3) & 7, stratum, precision, dispersion / 65536.0, ref_id)
+    elapsed = time.monotonic() - start
+
+    print("[ntp] wysłane %d, odpowiedzi %d, utracone %d, niezgodne %d" % (sent, len(rtts), lost, mismatched))
+    print("[ntp] przepustowość %.0f odpowiedzi/s" % (len(rtts) / elapsed))
+    if header:
+        leap, version, stratum, precision, dispersion, ref_id = header
+        print("[ntp] LI=%d VN=%d stratum=%d precyzja=2^%d dyspersja=%.6f s ref=%r" %
+              (leap, version, stratum, precision, dispersion, ref_id.rstrip(b"\0").decode("ascii", "replace")))
+    for name, values in (("RTT", rtts), ("obsługa", services)):
+        print("[ntp] %-8s p50=%.1f us p99=%.1f us max=%.1f us" %
+              (name, percentile(values, 50) * 1e6, percentile(values, 99) * 1e6,
+               (max(values) if values else 0) * 1e6))
+    if offsets:
+        print("[ntp] przesunięcie serwera p50=%+.6f s" % percentile(offsets, 50))
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,216 @@
+#!/usr/bin/env python3
+"""Klient czasu po USB (TimeLink.cpp): dyscyplina zegara hosta bez anteny GNSS.
+
+Wysyła ramki zapytania (typ 3) na port Serial urządzenia i z odpowiedzi
+(typ 4) liczy przesunięcie i opóźnienie jak NTP:
+  t1 - nadanie zapytania (host), t2 - odbiór, t3 - nadanie (urządzenie),
+  t4 - odbiór odpowiedzi (host)
+  przesunięcie = ((t2 - t1) + (t3 - t4)) / 2, opóźnienie = (t4 - t1) - (t3 - t2)
+Z każdej serii --burst zapytań brana jest próbka o najmniejszym opóźnieniu.
+Tekst raportu i ramki śledzenia między odpowiedziami są pomijane.
+
+Ramka: A5 5A | typ | długość (u16 LE) | dane | Fletcher-16 (u16 LE)
+  zapytanie (12 B): numer u32, znacznik hosta u64
+  odpowiedź (40 B): numer u32, znacznik hosta u64, odbiór s u32 us u32,
+    nadanie s u32 us u32, flagi u8, satelity u8, 0 u16,
+    od synchronizacji ms u32, szacowany błąd us u32
+
+Użycie: tools/timelink_client.py PORT [--interval 1] [--burst 4]
+                                 [--chrony-sock /var/run/chrony.ttyACM0.sock]
+                                 [--provisional]
+        tools/timelink_client.py PORT --bench 1000
+  --chrony-sock - próbki do chrony, w chrony.conf np.:
+      refclock SOCK /var/run/chrony.ttyACM0.sock refid GPSU delay 0.002
+  --provisional - próbki także z czasu tymczasowego (bez fiksa)
+  --bench N - N zapytań jedno po drugim: rozkład RTT i czas obsługi urządzenia
+Firmware na hoście: fw --usb-pty (ścieżka pseudoterminala na stderr).
+"""
+
+import argparse
+import os
+import select
+import socket
+import struct
+import sys
+import termios
+import time
+import tty
+
+FRAME_TIME_POLL = 3
+FRAME_TIME_REPLY = 4
+
+FLAG_CLOCK_SET = 1 << 0
+FLAG_FIX = 1 << 1
+FLAG_PROVISIONAL = 1 << 2
+FLAG_SYNC_FAILED = 1 << 3
+
+# struct sock_sample z refclock_sock.c (Linux, 64 bity)
+CHRONY_SOCK_MAGIC = 0x534F434B
+CHRONY_SAMPLE = struct.Struct("@qqdiiii")
+
+REPLY = struct.Struct("<IQIIIIBBHII")
+
+
+def fletcher16(data):
+    a = b = 0
+    for byte in data:
+        a = (a + byte) % 255
+        b = (b + a) % 255
+    return b << 8 | a
+
+
+def frame(kind, payload):
+    body = struct.pack("<BH", kind, len(payload)) + payload
+    return b"\xa5\x5a" + body + struct.pack("<H", fletcher16(body))
+
+
+def percentile(values, p):
+    if not values:
+        return 0.0
+    ordered = sorted(values)
+    return ordered[min(len(ordered) - 1, int(len(ordered) * p / 100))]
+
+
+class Link:
+    def __init__(self, path):
+        self.fd = os.open(path, os.O_RDWR | os.O_NOCTTY)
+        tty.setraw(self.fd, termios.TCSANOW)
+        self.buffer = b""
+        self.sequence = 0
+
+    def poll(self, timeout):
+        """Jedno zapytanie: (t1, t4, odpowiedź) w ns czasu hosta lub None."""
+        self.sequence = (self.sequence + 1) & 0xFFFFFFFF
+        t1 = time.time_ns()
+        os.write(self.fd, frame(FRAME_TIME_POLL, struct.pack("<IQ", self.sequence, t1)))
+        deadline = time.monotonic() + timeout
+        while True:
+            reply = self.take_reply()
+            if reply is not None:
+                t4 = time.time_ns()
+                if reply[0] == self.sequence and reply[1] == t1:
+                    return t1, t4, reply
+                continue  # spóźniona odpowiedź na wcześniejsze zapytanie
+            left = deadline - time.monotonic()
+            if left <= 0 or not select.select([self.fd], [], [], left)[0]:
+                return None
+            self.buffer += os.read(self.fd, 4096)
+
+    def take_reply(self):
+        while True:
+            i = self.buffer.find(b"\xa5\x5a")
+            if i < 0:
+                self.buffer = self.buffer[-1:]
+                return None
+            self.buffer = self.buffer[i:]
+            if len(self.buffer) < 5:
+                return None
+            kind, length = struct.unpack_from("<BH", self.buffer, 2)
+            if len(self.buffer) < 7 + length:
+                return None
+            body = self.buffer[2:5 + length]
+            check = struct.unpack_from("<H", self.buffer, 5 + length)[0]
+            if fletcher16(body) != check:
+                self.buffer = self.buffer[2:]
+                continue
+            self.buffer = self.buffer[7 + length:]
+            if kind == FRAME_TIME_REPLY and length == REPLY.size:
+                return REPLY.unpack(body[3:])
+
+
+def measure(t1, t4, reply):
+    """Przesunięcie i opóźnienie [s] z jednej odpowiedzi."""
+    t2 = reply[2] * 10 ** 9 + reply[3] * 1000
+    t3 = reply[4] * 10 ** 9 + reply[5] * 1000
+    offset = ((t2 - t1) + (t3 - t4)) / 2e9
+    delay = ((t4 - t1) - (t3 - t2)) / 1e9
+    return offset, delay
+
+
+def flags_text(flags):
+    names = [(FLAG_CLOCK_SET, "ustawiony"), (FLAG_FIX, "fiks"), (FLAG_PROVISIONAL, "tymczasowy"),
+             (FLAG_SYNC_FAILED, "sync-blad")]
+    return ",".join(name for bit, name in names if flags & bit) or "brak"
+
+
+def bench(link, count):
+    rtt = []
+    service = []
+    lost = 0
+    start = time.monotonic()
+    for _ in range(count):
+        result = link.poll(1.0)
+        if result is None:
+            lost += 1
+            continue
+        t1, t4, reply = result
+        rtt.append((t4 - t1) / 1e3)
+        service.append((reply[4] - reply[2]) * 1e6 + reply[5] - reply[3])
+    elapsed = time.monotonic() - start
+    print("zapytania %d, odpowiedzi %d, utracone %d, %.0f/s"
+          % (count, len(rtt), lost, len(rtt) / elapsed))
+    print("RTT [us]      p50 %.0f  p90 %.0f  p99 %.0f  min %.0f  max %.0f"
+          % (percentile(rtt, 50), percentile(rtt, 90), percentile(rtt, 99),
+             min(rtt or [0]), max(rtt or [0])))
+    print("obsluga [us]  p50 %.0f  p99 %.0f  max %.0f"
+          % (percentile(service, 50), percentile(service, 99), max(service or [0])))
+    return 0 if rtt else 1
+
+
+def discipline(link, args):
+    chrony = None
+    if args.chrony_sock:
+        chrony = socket.socket(socket.AF_UNIX, socket.SOCK_DGRAM)
+    while True:
+        cycle = time.monotonic()
+        best = None
+        for _ in range(args.burst):
+            result = link.poll(0.5)
+            if result is None:
+                continue
+            offset, delay = measure(*result)
+            if best is None or delay < best[1]:
+                best = (offset, delay, result)
+        if best is None:
+            print("brak odpowiedzi", file=sys.stderr)
+        else:
+            offset, delay, (t1, t4, reply) = best
+            flags, satellites, since_ms, error_us = reply[6], reply[7], reply[9], reply[10]
+            usable = flags & FLAG_CLOCK_SET and (flags & FLAG_FIX or
+                                                 (args.provisional and flags & FLAG_PROVISIONAL))
+            print("przesuniecie %+.6f s  opoznienie %.6f s  %s sat=%d od_sync=%ds blad=%dus%s"
+                  % (offset, delay, flags_text(flags), satellites, since_ms // 1000, error_us,
+                     "" if usable else "  (pominieta)"), flush=True)
+            if chrony is not None and usable:
+                # Próbka w chwili odbioru odpowiedzi: czas urządzenia = t4 + przesunięcie
+                sample = CHRONY_SAMPLE.pack(t4 // 10 ** 9, t4 % 10 ** 9 // 1000, offset,
+                                            0, 0, 0, CHRONY_SOCK_MAGIC)
+                try:
+                    chrony.sendto(sample, args.chrony_sock)
+                except OSError as error:
+                    print("chrony: %s" % error, file=sys.stderr)
+        time.sleep(max(0.0, args.interval - (time.monotonic() - cycle)))
+
+
+def main():
+    parser = argparse.ArgumentParser()
+    parser.add_argument("port")
+    parser.add_argument("--interval", type=float, default=1.0)
+    parser.add_argument("--burst", type=int, default=4)
+    parser.add_argument("--chrony-sock")
+    parser.add_argument("--provisional", action="store_true")
+    parser.add_argument("--bench", type=int, default=0)
+    args = parser.parse_args()
+
+    link = Link(args.port)
+    if args.bench > 0:
+        return bench(link, args.bench)
+    try:
+        discipline(link, args)
+    except KeyboardInterrupt:
+        pass
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,100 @@
+#!/usr/bin/env python3
+"""Dekoder ramek śledzenia (Trace.cpp) z zapisu portu USB.
+
+Ramka: A5 5A | typ | długość (u16 LE) | dane | Fletcher-16 (u16 LE)
+z typu, długości i danych. Tekst raportu między ramkami jest pomijany.
+
+  typ 1 - zdarzenia po 12 B: start_us u32, czas_us u32, arg u16, zdarzenie u8, 0
+  typ 2 - histogramy: liczba u8, kubełki u8, dla każdego max_us u32 i kubełki u32
+  typ 3, 4 - zapytanie i odpowiedź czasu (TimeLink.cpp, tools/timelink_client.py) - pomijane
+
+Użycie: tools/trace_decode.py [--events] [zapis.bin]   (domyślnie stdin)
+  bez --events: podsumowanie czasów na zdarzenie i ostatnie histogramy
+"""
+
+import struct
+import sys
+
+EVENTS = ["loop", "time_lcd", "date_lcd", "lcd_flush", "backlight", "gps_wait", "gps_batch", "sync"]
+HISTOGRAMS = ["okres petli", "ekran - sekunda"]
+
+
+def fletcher16(data):
+    a = b = 0
+    for byte in data:
+        a = (a + byte) % 255
+        b = (b + a) % 255
+    return b << 8 | a
+
+
+def frames(data):
+    """Kolejne poprawne ramki (typ, dane) oraz liczba błędnych."""
+    bad = 0
+    i = 0
+    out = []
+    while True:
+        i = data.find(b"\xa5\x5a", i)
+        if i < 0 or i + 5 > len(data):
+            return out, bad
+        kind = data[i + 2]
+        length = struct.unpack_from("<H", data, i + 3)[0]
+        end = i + 5 + length
+        if end + 2 > len(data):
+            return out, bad
+        check = struct.unpack_from("<H", data, end)[0]
+        if fletcher16(data[i + 2:end]) != check:
+            bad += 1
+            i += 2
+            continue
+        out.append((kind, data[i + 5:end]))
+        i = end + 2
+
+
+def bucket_label(b):
+    return "0" if b == 0 else "<%d" % (1 << b)
+
+
+def main():
+    args = [a for a in sys.argv[1:] if a != "--events"]
+    show_events = "--events" in sys.argv[1:]
+    data = open(args[0], "rb").read() if args else sys.stdin.buffer.read()
+    parsed, bad = frames(data)
+
+    totals = {}
+    histograms = None
+    for kind, payload in parsed:
+        if kind == 1:
+            for start, duration, arg, event, _ in struct.iter_unpack("<IIHBB", payload):
+                name = EVENTS[event] if event < len(EVENTS) else "ev%d" % event
+                if show_events:
+                    print("%10.6f %-10s %8d us arg=%d" % (start / 1e6, name, duration, arg))
+                count, total, peak = totals.get(name, (0, 0, 0))
+                totals[name] = (count + 1, total + duration, max(peak, duration))
+        elif kind == 2:
+            count, buckets = payload[0], payload[1]
+            histograms = []
+            offset = 2
+            for _ in range(count):
+                peak = struct.unpack_from("<I", payload, offset)[0]
+                values = struct.unpack_from("<%dI" % buckets, payload, offset + 4)
+                histograms.append((peak, values))
+                offset += 4 + 4 * buckets
+
+    print("ramki: %d, bledne: %d" % (len(parsed), bad))
+    print("%-10s %8s %10s %10s" % ("zdarzenie", "liczba", "sr. [us]", "max [us]"))
+    for name in EVENTS:
+        if name in totals:
+            count, total, peak = totals[name]
+            print("%-10s %8d %10.1f %10d" % (name, count, total / count, peak))
+    if histograms:
+        for index, (peak, values) in enumerate(histograms):
+            name = HISTOGRAMS[index] if index < len(HISTOGRAMS) else "h%d" % index
+            print("%s (max %d us):" % (name, peak))
+            for b, value in enumerate(values):
+                if value:
+                    print("  %8s us %8d" % (bucket_label(b) if b < len(values) - 1 else ">=%d" % (1 << (b - 1)),
+                                           value))
+
+
+if __name__ == "__main__":
+    main()